@@ -0,0 +1,57 @@
+#ifndef ALIGN_H
+#define ALIGN_H
+
+// Block placement on a grid of cellSize wide columns, cell n covering pixels
+// n * cellSize .. (n + 1) * cellSize - 1. A row of the tower is a bit mask with
+// bit n set for every cell it occupies (up to 32 cells). Dropping a block keeps
+// the cells that are both in the row below and covered by the dropped block,
+// which is a single AND no matter how wide the block or the playfield is.
+
+// Cells fully covered by the span xs..xe, where each cell edge may stick out of
+// the span by up to tolerance pixels and still count as covered
+unsigned long alignCells(int xs, int xe, unsigned char cellSize, unsigned char tolerance) {
+  int from = xs - tolerance;        // leftmost pixel a covered cell may start at
+  int to = xe + tolerance + 1;      // one past the rightmost pixel it may end at
+  if (from < 0) {
+    from = 0;
+  }
+  if (to <= from) {
+    return 0;
+  }
+  unsigned char first = (from + cellSize - 1) / cellSize;  // round up
+  unsigned char end = to / cellSize;                        // round down, exclusive
+  if (end > 32) {
+    end = 32;
+  }
+  if (end <= first) {
+    return 0;
+  }
+  unsigned long upTo = (end == 32) ? 0xFFFFFFFFUL : ((1UL << end) - 1);
+  return upTo & ~((1UL << first) - 1);
+}
+
+// Lowest and highest cell in a non-empty mask
+void alignSpan(unsigned long cells, unsigned char &firstCell, unsigned char &lastCell) {
+  firstCell = 0;
+  while (!(cells & (1UL << firstCell))) {
+    ++firstCell;
+  }
+  lastCell = firstCell;
+  while ((lastCell < 31) && (cells & (1UL << (lastCell + 1)))) {
+    ++lastCell;
+  }
+}
+
+// Drop a block spanning xs..xe onto the row occupying belowCells. Returns false if
+// nothing survives, otherwise the surviving cells in firstCell..lastCell.
+bool alignResolve(unsigned long belowCells, int xs, int xe, unsigned char cellSize, unsigned char tolerance,
+                  unsigned char &firstCell, unsigned char &lastCell) {
+  unsigned long kept = belowCells & alignCells(xs, xe, cellSize, tolerance);
+  if (!kept) {
+    return false;
+  }
+  alignSpan(kept, firstCell, lastCell);
+  return true;
+}
+
+#endif // ALIGN_H
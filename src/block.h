@@ -0,0 +1,154 @@
+#ifndef BLOCK_H
+#define BLOCK_H
+
+#include "st7735.h"
+
+// Blocks are generated from a description of the pattern instead of a bitmap: a row
+// of square cells, each a filled middle with a border around it. The pattern repeats
+// every cellSize pixels across, so a window of any width gives whole and partial
+// cells, and any rows below the cells are drawn in the gap color.
+
+struct blockStyle {
+  unsigned char cellSize;   // width and height of one cell in pixels
+  unsigned char border;     // border thickness in pixels
+  unsigned int borderColor;
+  unsigned int fillColor;
+  unsigned int gapColor;    // rows past cellSize, and columns a moving block uncovers
+};
+
+// One pixel row through the middle of the cells, as runs of the same color.
+// A right border and the next cell's left border go out as one run.
+void _blockCellRow(unsigned int width, const blockStyle &style) {
+  unsigned char phase = 0; // position inside the current cell
+  while (width) {
+    unsigned int color;
+    unsigned char run;
+    if (phase < style.border) {
+      color = style.borderColor;
+      run = style.border - phase;
+    }
+    else if (phase < style.cellSize - style.border) {
+      color = style.fillColor;
+      run = (style.cellSize - style.border) - phase;
+    }
+    else {
+      color = style.borderColor;
+      run = (style.cellSize - phase) + style.border;
+    }
+    if (run > width) {
+      run = width;
+    }
+    st7735_fill(color, run);
+    width -= run;
+    phase = (phase + run) % style.cellSize;
+  }
+}
+
+// Fill the window with the block pattern, cells starting at blockXS
+void drawBlockSpan(int blockXS, int blockXE, int blockYS, int blockYE, const blockStyle &style) {
+  unsigned int width = (blockXE - blockXS) + 1;
+  unsigned int height = (blockYE - blockYS) + 1;
+  unsigned char lowerBorder = style.cellSize - style.border; // first row of the bottom border
+
+  st7735_begin();
+  st7735_window(blockXS, blockXE, blockYS, blockYE);
+  for (unsigned int row = 0; row < height; ++row) {
+    if (row >= style.cellSize) {
+      st7735_fill(style.gapColor, width);
+    }
+    else if (row < style.border || row >= lowerBorder) {
+      st7735_fill(style.borderColor, width);
+    }
+    else {
+      _blockCellRow(width, style);
+    }
+  }
+  st7735_end();
+}
+
+/*****************************************************************************/
+// Moving blocks. A block that slides one pixel doesn't need a full redraw: only the
+// column it moves into, the column it leaves, and the columns where the pattern
+// switches between border and fill (two per cell) look different afterwards. For a
+// 3 cell block that is 8 columns instead of 36.
+
+struct blockSprite {
+  int xs, xe, ys, ye; // where it is on the panel right now
+  bool drawn;         // false until the first full draw, or after the panel was cleared
+};
+
+// Is column phase of the pattern (counted from the block's left edge) all border?
+bool _blockBorderColumn(int phase, const blockStyle &style) {
+  unsigned char cell = phase % style.cellSize;
+  return cell < style.border || cell >= style.cellSize - style.border;
+}
+
+// One column of the pattern at panel column x
+void _blockColumn(int x, int ys, int ye, bool border, const blockStyle &style) {
+  unsigned int height = (ye - ys) + 1;
+  unsigned char rows = (height < style.cellSize) ? height : style.cellSize;
+
+  st7735_begin();
+  st7735_window(x, x, ys, ye);
+  if (border) {
+    st7735_fill(style.borderColor, rows);
+  }
+  else {
+    unsigned char lowerBorder = style.cellSize - style.border;
+    unsigned char top = (rows < style.border) ? rows : style.border;
+    unsigned char middle = ((rows < lowerBorder) ? rows : lowerBorder) - top;
+    st7735_fill(style.borderColor, top);
+    st7735_fill(style.fillColor, middle);
+    st7735_fill(style.borderColor, rows - top - middle);
+  }
+  st7735_fill(style.gapColor, height - rows);
+  st7735_end();
+}
+
+// Where moveBlockSprite() sends the pieces it draws: blockDrawNow puts them on the
+// panel straight away, dlDraw in displaylist.h queues them.
+struct blockDrawNow {
+  static void span(int xs, int xe, int ys, int ye, const blockStyle &style) {
+    drawBlockSpan(xs, xe, ys, ye, style);
+  }
+  static void column(int x, int ys, int ye, bool border, const blockStyle &style) {
+    _blockColumn(x, ys, ye, border, style);
+  }
+  static void fill(int xs, int xe, int ys, int ye, unsigned int color) {
+    st7735_begin();
+    st7735_window(xs, xe, ys, ye);
+    st7735_fill(color, (unsigned long)((xe - xs) + 1) * ((ye - ys) + 1));
+    st7735_end();
+  }
+};
+
+// Put the sprite at xs..xe, ys..ye. One pixel moves with the same size in the same
+// band are done column by column, anything else is a full draw.
+template <class Draw = blockDrawNow>
+void moveBlockSprite(blockSprite &sprite, int xs, int xe, int ys, int ye, const blockStyle &style) {
+  int shift = xs - sprite.xs;
+  if (!sprite.drawn || ys != sprite.ys || ye != sprite.ye || (xe - xs) != (sprite.xe - sprite.xs)
+      || (shift != 1 && shift != -1)) {
+    Draw::span(xs, xe, ys, ye, style);
+  }
+  else {
+    // column given up on the trailing side
+    int vacated = (shift > 0) ? sprite.xs : sprite.xe;
+    Draw::fill(vacated, vacated, ys, ye, style.gapColor);
+
+    for (int x = xs; x <= xe; ++x) {
+      bool border = _blockBorderColumn(x - xs, style);
+      bool covered = (x >= sprite.xs && x <= sprite.xe);
+      if (!covered || border != _blockBorderColumn(x - sprite.xs, style)) {
+        Draw::column(x, ys, ye, border, style);
+      }
+    }
+  }
+  sprite.xs = xs;
+  sprite.xe = xe;
+  sprite.ys = ys;
+  sprite.ye = ye;
+  sprite.drawn = true;
+}
+
+#endif // BLOCK_H
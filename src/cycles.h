@@ -0,0 +1,43 @@
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include "hal.h"
+
+// Free running cycle counter on Timer1. Timer1 counts every CPU cycle (no prescaler) and
+// the overflow interrupt extends it to 32 bits, so CYCLES_NOW() wraps after about 268 s
+// at 16 MHz. Differences of two readings are still right across a wrap as long as the
+// interval itself is shorter than that.
+
+volatile unsigned int _cycles_overflows = 0; // upper 16 bits of the count
+
+void CYCLES_INIT() {
+	TCCR1A = 0x00;
+	TCCR1B = (1 << CS10);	// normal mode, clk/1
+	TCNT1 = 0;
+	TIMSK1 |= (1 << TOIE1);	// overflow interrupt
+}
+
+unsigned long CYCLES_NOW() {
+	unsigned char sreg = SREG;
+	cli();
+	unsigned int low = TCNT1;
+	unsigned int high = _cycles_overflows;
+	// an overflow that happened after cli() has not been counted yet
+	if ((TIFR1 & (1 << TOV1)) && low < 0x8000) {
+		++high;
+	}
+	SREG = sreg;
+	return ((unsigned long)high << 16) | low;
+}
+
+// Cycles to microseconds, without going through a 32 bit division by F_CPU
+unsigned long CYCLES_TO_US(unsigned long cycles) {
+	return cycles / (F_CPU / 1000000UL);
+}
+
+ISR(TIMER1_OVF_vect)
+{
+	++_cycles_overflows;
+}
+
+#endif // CYCLES_H
@@ -0,0 +1,369 @@
+#ifndef DISPLAYLIST_H
+#define DISPLAYLIST_H
+
+#include "hal.h"
+#include "timer.h"
+#include "st7735.h"
+#include "font.h"
+#include "block.h"
+
+// Display list: the tasks don't draw, they queue small draw commands (fill, block,
+// block column, glyph, string, scroll) into a fixed arena, and the main loop draws
+// them with dlRun() in the time left before the next task is due. A long screen
+// can't hold up the move and button tasks that way; it goes out a piece at a time
+// between their ticks. A piece is one glyph, one block or block column, or about
+// DL_FILL_CHUNK pixels of a fill, so a slice overshoots its budget by one piece at
+// most.
+//
+// Fills go through the dirty rectangles in st7735.h, which cut out whatever is drawn
+// over them; what is left is sent in DL_FILL_CHUNK pieces once the list is empty.
+//
+// The arena is a ring of DISPLAY_LIST_BYTES. A task that queues more than fits
+// draws the oldest commands itself until there is room (counted in dlStalls). A fill
+// first takes back the commands queued last that it would paint over completely, so
+// clearing the screen over and over (the win screen's confetti) doesn't pile up.
+// Coordinates are 0..255 and strings have to stay in memory until they are drawn,
+// which string literals do.
+
+#ifndef DISPLAY_LIST_BYTES
+#define DISPLAY_LIST_BYTES 128 // a power of two
+#endif
+
+#define DL_FILL_CHUNK 512                   // pixels, about 1.3 ms of SPI at 16 bit
+#define DL_STEP_TICKS TIMER_MS_TO_TICKS(2)  // the longest piece, kept clear of the next task
+
+enum dlOps {DL_FILL, DL_BLOCK, DL_COLUMN, DL_GLYPH, DL_STRING, DL_SCROLL};
+
+// Bytes a command takes in the arena: op, arguments and op again, so the list can be
+// walked back from the head
+#define DL_PTR_BYTES sizeof(void *)
+const unsigned char _dlSizes[] = {
+  2 + 4 + 2,                // DL_FILL: xs, xe, ys, ye, color
+  2 + 4 + DL_PTR_BYTES,     // DL_BLOCK: xs, xe, ys, ye, style
+  2 + 4 + DL_PTR_BYTES,     // DL_COLUMN: x, border, ys, ye, style
+  2 + 3 + 4,                // DL_GLYPH: x, y, c, fg, bg
+  2 + 2 + DL_PTR_BYTES + 4, // DL_STRING: x, y, str, fg, bg
+  2 + 1,                    // DL_SCROLL: line
+};
+
+unsigned char _dlArena[DISPLAY_LIST_BYTES];
+unsigned int _dlHead = 0; // next byte written
+unsigned int _dlTail = 0; // next byte read
+unsigned int _dlUsed = 0;
+
+unsigned int dlStalls = 0; // commands that had to wait for room in the arena
+
+// The command being drawn, taken out of the arena
+struct _dlCommand {
+  unsigned char op;
+  int xs, xe, ys, ye; // DL_GLYPH and DL_STRING: xs, ys; DL_COLUMN: xe is the border flag
+  unsigned int color, bg;
+  char c;
+  const char *str;
+  const blockStyle *style;
+};
+
+_dlCommand _dlCurrent;
+bool _dlBusy = false; // _dlCurrent isn't finished
+
+void _dlPut(unsigned char b) {
+  _dlArena[_dlHead] = b;
+  _dlHead = (_dlHead + 1) & (DISPLAY_LIST_BYTES - 1);
+  ++_dlUsed;
+}
+
+unsigned char _dlGet() {
+  unsigned char b = _dlArena[_dlTail];
+  _dlTail = (_dlTail + 1) & (DISPLAY_LIST_BYTES - 1);
+  --_dlUsed;
+  return b;
+}
+
+void _dlPutWord(unsigned int w) {
+  _dlPut(w >> 8);
+  _dlPut(w & 0xFF);
+}
+
+unsigned int _dlGetWord() {
+  unsigned int w = _dlGet() << 8;
+  return w | _dlGet();
+}
+
+void _dlPutPtr(const void *p) {
+  const unsigned char *bytes = (const unsigned char *)&p;
+  for (unsigned char i = 0; i < DL_PTR_BYTES; ++i) {
+    _dlPut(bytes[i]);
+  }
+}
+
+const void *_dlGetPtr() {
+  const void *p;
+  unsigned char *bytes = (unsigned char *)&p;
+  for (unsigned char i = 0; i < DL_PTR_BYTES; ++i) {
+    bytes[i] = _dlGet();
+  }
+  return p;
+}
+
+void _dlPop() {
+  _dlCommand &cmd = _dlCurrent;
+  cmd.op = _dlGet();
+  switch (cmd.op) {
+    case DL_FILL:
+    case DL_BLOCK:
+    case DL_COLUMN:
+      cmd.xs = _dlGet();
+      cmd.xe = _dlGet();
+      cmd.ys = _dlGet();
+      cmd.ye = _dlGet();
+      if (cmd.op == DL_FILL) {
+        cmd.color = _dlGetWord();
+      }
+      else {
+        cmd.style = (const blockStyle *)_dlGetPtr();
+      }
+      break;
+    case DL_GLYPH:
+    case DL_STRING:
+      cmd.xs = _dlGet();
+      cmd.ys = _dlGet();
+      if (cmd.op == DL_GLYPH) {
+        cmd.c = _dlGet();
+      }
+      else {
+        cmd.str = (const char *)_dlGetPtr();
+      }
+      cmd.color = _dlGetWord();
+      cmd.bg = _dlGetWord();
+      break;
+    case DL_SCROLL:
+      cmd.ys = _dlGet();
+      break;
+    default:
+      break;
+  }
+  _dlGet(); // op again
+  _dlBusy = true;
+}
+
+// Draw one piece of the current command. Returns false if there was nothing to draw.
+bool dlStep() {
+  if (!_dlBusy) {
+    if (!_dlUsed) {
+      return st7735_flushDirtySome(DL_FILL_CHUNK);
+    }
+    _dlPop();
+  }
+
+  _dlCommand &cmd = _dlCurrent;
+  switch (cmd.op) {
+    case DL_FILL:
+      st7735_fillRect(cmd.xs, cmd.xe, cmd.ys, cmd.ye, cmd.color);
+      break;
+    case DL_BLOCK:
+      blockDrawNow::span(cmd.xs, cmd.xe, cmd.ys, cmd.ye, *cmd.style);
+      break;
+    case DL_COLUMN:
+      blockDrawNow::column(cmd.xs, cmd.ys, cmd.ye, cmd.xe, *cmd.style);
+      break;
+    case DL_GLYPH:
+      drawChar(cmd.xs, cmd.ys, cmd.c, cmd.color, cmd.bg);
+      break;
+    case DL_STRING:
+      // a glyph per step, the way drawString() lays them out
+      if (*cmd.str) {
+        drawChar(cmd.xs, cmd.ys, *cmd.str++, cmd.color, cmd.bg);
+        cmd.xs -= FONT_WIDTH;
+      }
+      if (*cmd.str) {
+        return true;
+      }
+      break;
+    case DL_SCROLL:
+      // fills queued before the scroll have to be on the panel when it moves
+      st7735_flushDirty();
+      st7735_scrollTo(cmd.ys);
+      break;
+    default:
+      break;
+  }
+  _dlBusy = false;
+  return true;
+}
+
+// Nothing queued and nothing waiting to be sent, what was asked for is on the panel
+bool dlIdle() {
+  return !_dlBusy && !_dlUsed && !st7735_dirtyPending();
+}
+
+// Draw until deadline (TimerNow() ticks) is DL_STEP_TICKS away, at least one piece
+void dlRun(unsigned long deadline) {
+  do {
+    if (!dlStep()) {
+      return;
+    }
+  } while ((long)(deadline - TimerNow()) > (long)DL_STEP_TICKS);
+}
+
+// Draw everything now
+void dlFinish() {
+  while (dlStep()) {
+  }
+}
+
+// Room for a command of op, drawing the oldest ones if there isn't
+void _dlBegin(unsigned char op) {
+  if (DISPLAY_LIST_BYTES - _dlUsed < _dlSizes[op]) {
+    ++dlStalls;
+    while (DISPLAY_LIST_BYTES - _dlUsed < _dlSizes[op]) {
+      dlStep();
+    }
+  }
+  _dlPut(op);
+}
+
+void _dlEnd(unsigned char op) {
+  _dlPut(op);
+}
+
+unsigned char _dlPeek(unsigned int at) {
+  return _dlArena[at & (DISPLAY_LIST_BYTES - 1)];
+}
+
+// The pixels the queued command at arena offset at draws, corners inclusive. False
+// for a scroll, which moves everything.
+bool _dlArea(unsigned int at, int &xs, int &xe, int &ys, int &ye) {
+  switch (_dlPeek(at)) {
+    case DL_FILL:
+    case DL_BLOCK:
+      xs = _dlPeek(at + 1);
+      xe = _dlPeek(at + 2);
+      ys = _dlPeek(at + 3);
+      ye = _dlPeek(at + 4);
+      return true;
+    case DL_COLUMN:
+      xs = xe = _dlPeek(at + 1);
+      ys = _dlPeek(at + 3);
+      ye = _dlPeek(at + 4);
+      return true;
+    case DL_GLYPH:
+    case DL_STRING: {
+      xs = _dlPeek(at + 1);
+      ys = _dlPeek(at + 2);
+      xe = xs + FONT_WIDTH - 1;
+      ye = ys + FONT_HEIGHT - 1;
+      if (_dlPeek(at) == DL_STRING) {
+        // drawString() goes right to left from x
+        const char *str;
+        unsigned char *bytes = (unsigned char *)&str;
+        for (unsigned char i = 0; i < DL_PTR_BYTES; ++i) {
+          bytes[i] = _dlPeek(at + 3 + i);
+        }
+        for (; *str && str[1]; ++str) {
+          xs -= FONT_WIDTH;
+        }
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Take back the newest commands while the fill xs..xe, ys..ye would paint over all
+// of them. The one being drawn is out of the arena already and stays.
+void _dlDropCovered(int xs, int xe, int ys, int ye) {
+  while (_dlUsed) {
+    unsigned char size = _dlSizes[_dlPeek(_dlHead - 1)];
+    unsigned int at = (_dlHead - size) & (DISPLAY_LIST_BYTES - 1);
+    int cxs, cxe, cys, cye;
+    if (!_dlArea(at, cxs, cxe, cys, cye) ||
+        cxs < xs || cxe > xe || cys < ys || cye > ye) {
+      return;
+    }
+    _dlHead = at;
+    _dlUsed -= size;
+  }
+}
+
+/*****************************************************************************/
+// Queueing, same arguments as the functions that draw straight away
+
+// fillRect(), corners inclusive
+void dlFill(int xs, int xe, int ys, int ye, unsigned int color) {
+  _dlDropCovered(xs, xe, ys, ye);
+  _dlBegin(DL_FILL);
+  _dlPut(xs);
+  _dlPut(xe);
+  _dlPut(ys);
+  _dlPut(ye);
+  _dlPutWord(color);
+  _dlEnd(DL_FILL);
+}
+
+// drawBlockSpan()
+void dlBlock(int xs, int xe, int ys, int ye, const blockStyle &style) {
+  _dlBegin(DL_BLOCK);
+  _dlPut(xs);
+  _dlPut(xe);
+  _dlPut(ys);
+  _dlPut(ye);
+  _dlPutPtr(&style);
+  _dlEnd(DL_BLOCK);
+}
+
+// One column of a block, see moveBlockSprite()
+void dlColumn(int x, int ys, int ye, bool border, const blockStyle &style) {
+  _dlBegin(DL_COLUMN);
+  _dlPut(x);
+  _dlPut(border);
+  _dlPut(ys);
+  _dlPut(ye);
+  _dlPutPtr(&style);
+  _dlEnd(DL_COLUMN);
+}
+
+// drawChar()
+void dlGlyph(int x, int y, char c, unsigned int fg, unsigned int bg) {
+  _dlBegin(DL_GLYPH);
+  _dlPut(x);
+  _dlPut(y);
+  _dlPut(c);
+  _dlPutWord(fg);
+  _dlPutWord(bg);
+  _dlEnd(DL_GLYPH);
+}
+
+// drawString()
+void dlString(int x, int y, const char *str, unsigned int fg, unsigned int bg) {
+  _dlBegin(DL_STRING);
+  _dlPut(x);
+  _dlPut(y);
+  _dlPutPtr(str);
+  _dlPutWord(fg);
+  _dlPutWord(bg);
+  _dlEnd(DL_STRING);
+}
+
+// st7735_scrollTo()
+void dlScroll(unsigned char line) {
+  _dlBegin(DL_SCROLL);
+  _dlPut(line);
+  _dlEnd(DL_SCROLL);
+}
+
+// moveBlockSprite<dlDraw>() queues instead of drawing
+struct dlDraw {
+  static void span(int xs, int xe, int ys, int ye, const blockStyle &style) {
+    dlBlock(xs, xe, ys, ye, style);
+  }
+  static void column(int x, int ys, int ye, bool border, const blockStyle &style) {
+    dlColumn(x, ys, ye, border, style);
+  }
+  static void fill(int xs, int xe, int ys, int ye, unsigned int color) {
+    dlFill(xs, xe, ys, ye, color);
+  }
+};
+/*****************************************************************************/
+
+#endif // DISPLAYLIST_H
@@ -0,0 +1,394 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include "hal.h"
+#include "st7735.h"
+
+// 1 bit per pixel font kept in flash. Every glyph is a 10 x 30 cell, stored one
+// row per word with the leftmost pixel in bit 9. Only rows FONT_FIRST_ROW up to
+// FONT_FIRST_ROW + FONT_ROWS - 1 are stored, everything above and below is
+// background. The panel is mounted upside down, so the bitmaps are stored the
+// way they land in panel RAM and strings run towards x = 0.
+
+#define FONT_WIDTH 10
+#define FONT_HEIGHT 30
+#define FONT_FIRST_ROW 6
+#define FONT_ROWS 21
+
+// Characters in the same order as fontGlyphs. '*' is the confetti piece.
+const char fontChars[] = "STACKERINOGMV*";
+
+const unsigned int fontGlyphs[][FONT_ROWS] PROGMEM = {
+  { // 'S'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0001111110,
+    0b0001111110,
+    0b0110000000,
+    0b0110000000,
+    0b0001111000,
+    0b0001111000,
+    0b0000000110,
+    0b0000000110,
+    0b0111111000,
+    0b0111111000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'T'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0111111110,
+    0b0111111110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'A'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0011000110,
+    0b0011000110,
+    0b0011000110,
+    0b0011000110,
+    0b0011111110,
+    0b0011111110,
+    0b0011000110,
+    0b0011000110,
+    0b0001111000,
+    0b0001111000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'C'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0001111000,
+    0b0001111000,
+    0b0110000110,
+    0b0110000110,
+    0b0000000110,
+    0b0000000110,
+    0b0110000110,
+    0b0110000110,
+    0b0001111000,
+    0b0001111000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'K'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0110000110,
+    0b0110000110,
+    0b0001100110,
+    0b0001100110,
+    0b0000011110,
+    0b0000011110,
+    0b0001100110,
+    0b0001100110,
+    0b0110000110,
+    0b0110000110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'E'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0111111110,
+    0b0111111110,
+    0b0000000110,
+    0b0000000110,
+    0b0001111110,
+    0b0001111110,
+    0b0000000110,
+    0b0000000110,
+    0b0111111110,
+    0b0111111110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'R'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0110000110,
+    0b0110000110,
+    0b0001100110,
+    0b0001100110,
+    0b0001111110,
+    0b0001111110,
+    0b0110000110,
+    0b0110000110,
+    0b0001111110,
+    0b0001111110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'I'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0111111110,
+    0b0111111110,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0000110000,
+    0b0111111110,
+    0b0111111110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'N'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0110000110,
+    0b0110000110,
+    0b0110000110,
+    0b0110000110,
+    0b0111100110,
+    0b0111100110,
+    0b0110011110,
+    0b0110011110,
+    0b0110000110,
+    0b0110000110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'O'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0001111000,
+    0b0001111000,
+    0b0110000110,
+    0b0110000110,
+    0b0110000110,
+    0b0110000110,
+    0b0110000110,
+    0b0110000110,
+    0b0001111000,
+    0b0001111000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'G'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0001111000,
+    0b0001111000,
+    0b0110000110,
+    0b0110000110,
+    0b0111100110,
+    0b0111100110,
+    0b0000000110,
+    0b0000000110,
+    0b0001111000,
+    0b0001111000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'M'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100110011,
+    0b1100110011,
+    0b1111001111,
+    0b1111001111,
+    0b1100000011,
+    0b1100000011,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // 'V'
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000110000,
+    0b0000110000,
+    0b0011001100,
+    0b0011001100,
+    0b0011001100,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b1100000011,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+  },
+  { // '*'
+    0b0000001110,
+    0b0000001110,
+    0b0000001110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0111000000,
+    0b0111000000,
+    0b0111000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000001110,
+    0b0000001110,
+    0b0000001110,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0000000000,
+    0b0111000000,
+    0b0111000000,
+    0b0111000000,
+  },
+};
+
+// Flash address of the glyph for c, or 0 if the font doesn't have it
+const unsigned int *fontGlyph(char c) {
+  for (unsigned char i = 0; fontChars[i]; ++i) {
+    if (fontChars[i] == c) {
+      return fontGlyphs[i];
+    }
+  }
+  return 0;
+}
+
+// Draw one character cell with its top left corner at (x, y). Every font pixel
+// becomes a scale x scale square. Characters the font doesn't have come out as
+// a blank cell in the background color.
+void drawChar(int x, int y, char c, unsigned int fg, unsigned int bg, unsigned char scale = 1) {
+  const unsigned int *glyph = fontGlyph(c);
+  unsigned int width = FONT_WIDTH * scale;
+
+  st7735_begin();
+  st7735_window(x, x + width - 1, y, y + (FONT_HEIGHT * scale) - 1);
+  st7735_fill(bg, (unsigned long)FONT_FIRST_ROW * scale * width);
+  for (unsigned char row = 0; row < FONT_ROWS; ++row) {
+    unsigned int bits = glyph ? pgm_read_word(&glyph[row]) : 0;
+    for (unsigned char sy = 0; sy < scale; ++sy) {
+      if (bits == 0) {
+        st7735_fill(bg, width);
+        continue;
+      }
+      for (unsigned int mask = 1 << (FONT_WIDTH - 1); mask; mask >>= 1) {
+        unsigned int color = (bits & mask) ? fg : bg;
+        for (unsigned char sx = 0; sx < scale; ++sx) {
+          st7735_pixel(color);
+        }
+      }
+    }
+  }
+  st7735_fill(bg, (unsigned long)(FONT_HEIGHT - FONT_FIRST_ROW - FONT_ROWS) * scale * width);
+  st7735_end();
+}
+
+// Draw a string starting with its first character at (x, y), one cell further
+// towards x = 0 for every following character.
+void drawString(int x, int y, const char *str, unsigned int fg, unsigned int bg, unsigned char scale = 1) {
+  while (*str) {
+    drawChar(x, y, *str++, fg, bg, scale);
+    x -= FONT_WIDTH * scale;
+  }
+}
+
+#endif // FONT_H
@@ -0,0 +1,96 @@
+#ifndef GPIO_H
+#define GPIO_H
+
+#include "hal.h"
+
+/*****************************************************************************/
+// Don't worry about the struct definitions---just look at the get and set functions
+
+struct B {
+    bool operator()(int pad) { return PINB & (1 << pad); } 
+    void operator()(int pad, bool value) { 
+        PORTB = (value) ? PORTB | (1 << pad) : PORTB & ~(1 << pad);
+    }
+};
+
+struct C {
+    bool operator()(int pad) { return PINC & (1 << pad); } 
+    void operator()(int pad, bool value) {
+        PORTC = (value) ? PORTC | (1 << pad) : PORTC & ~(1 << pad);
+    }
+};
+
+struct D {
+    bool operator()(int pad) { return PIND & (1 << pad); } 
+    void operator()(int pad, bool value) { 
+        PORTD = (value) ? PORTD | (1 << pad) : PORTD & ~(1 << pad);
+    }
+};
+
+// get function: fetches values from pin registers
+// Sample Usage:
+// get<B>(7) -- gets the value at PINB7 (returns 1 or 0)
+// get<D>(5) -- gets the value at PIND5 (returns 1 or 0)
+template <typename Group>
+bool get(int pad) {
+    return Group()(pad);
+}
+
+// set function: sets value at port regsiter
+// Note: This function DOES NOT disturb the other bits in the register
+// Sample Usage:
+// set<C>(5, 0) -- sets PORTC5 to 0
+// set<B>(6, 1) -- sets PORTC6 to 1
+// set<D>(7, true) -- sets PORTD7 to 1
+template <typename Group>
+void set(int pad, bool value) {
+    Group()(pad, value);
+}
+/*****************************************************************************/
+
+// Compile time pins: Pin<PortB, 2>::set() etc. The port and bit are template
+// arguments, so every call inlines to a single sbi/cbi/sbic instruction instead of
+// the read-modify-write with a computed shift that set<B>(pad, value) turns into
+// when pad isn't known at compile time. Use these for pins toggled in hot paths.
+// Sample Usage:
+// typedef Pin<PortD, 7> LCD_A0;
+// LCD_A0::output(); -- make it an output
+// LCD_A0::clear(); -- PORTD7 = 0
+// LCD_A0::toggle(); -- flips PORTD7 by writing 1 to PIND7
+struct PortB {
+    static halReg8 &port() { return PORTB; }
+    static halReg8 &pin() { return PINB; }
+    static halReg8 &ddr() { return DDRB; }
+};
+
+struct PortC {
+    static halReg8 &port() { return PORTC; }
+    static halReg8 &pin() { return PINC; }
+    static halReg8 &ddr() { return DDRC; }
+};
+
+struct PortD {
+    static halReg8 &port() { return PORTD; }
+    static halReg8 &pin() { return PIND; }
+    static halReg8 &ddr() { return DDRD; }
+};
+
+template <typename Port, unsigned char N>
+struct Pin {
+    static void set() { Port::port() |= (1 << N); }
+    static void clear() { Port::port() &= ~(1 << N); }
+    static void toggle() { Port::pin() = (1 << N); } // writing a 1 to PINx flips PORTx
+    static bool read() { return Port::pin() & (1 << N); }
+    static void write(bool value) {
+        if (value) {
+            set();
+        }
+        else {
+            clear();
+        }
+    }
+    static void output() { Port::ddr() |= (1 << N); }
+    static void input() { Port::ddr() &= ~(1 << N); }
+};
+
+#endif // GPIO_H
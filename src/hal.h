@@ -0,0 +1,32 @@
+#ifndef HAL_H
+#define HAL_H
+
+// Everything that talks to the chip includes this instead of the avr-libc headers.
+// On the ATmega328P it is just those headers. The native build (-DNATIVE, pio run -e
+// native) swaps in native/sim.h, which provides the same register names on top of
+// simulated peripherals so the whole game runs on a PC, with native/st7735_sim.h
+// standing in for the panel.
+
+#ifdef NATIVE
+#include "native/sim.h"
+#include "native/st7735_sim.h"
+
+#define HAL_FRAME_END() simPanelEndFrame()
+#else
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+#include <util/delay.h>
+
+typedef volatile unsigned char halReg8; // type of PORTB, PINB, DDRB...
+
+// Body of busy-wait loops on a flag an interrupt clears. Nothing to do on the chip,
+// the simulator lets its peripherals run here.
+#define HAL_POLL()
+
+// End of a pass of the main loop, where the simulated panel closes its frame counters
+#define HAL_FRAME_END()
+#endif
+
+#endif // HAL_H
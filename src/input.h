@@ -0,0 +1,185 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "hal.h"
+#include "cycles.h"
+
+// Button input on PORTC. Two interrupts work together:
+//
+//  - The pin change interrupt notes when a line first moves away from its settled
+//    level, stamped with CYCLES_NOW(), so the game knows when a button went down
+//    instead of when it next looked at the pin.
+//  - Timer0 samples PINC every 2 ms and debounces all lines at once with a 3 bit
+//    vertical counter: a line only changes state after it has read the new level
+//    for its configured number of samples in a row. Each change sets a pressed or
+//    released flag and queues an event carrying the time of the first raw edge.
+//
+// Needs CYCLES_INIT() for the timestamps. The event queue has a single consumer; if
+// it fills up, newer events are dropped until it is read. The flags can be polled
+// from anywhere.
+
+#define BUTTON_PLACE 0 // PC0, drops the moving block
+#define BUTTON_START 1 // PC1, start / reset
+
+#define INPUT_MASK ((1 << BUTTON_PLACE) | (1 << BUTTON_START))
+#define INPUT_QUEUE_SIZE 8 // MUST BE A POWER OF TWO
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+
+#define INPUT_SAMPLE_MS 2
+#define INPUT_DEFAULT_SAMPLES 5 // 10 ms of steady level, 1..7 per line
+
+struct inputEvent {
+  unsigned char line;  // PORTC bit
+  bool pressed;        // true for a press (buttons read 1 while held)
+  unsigned long time;  // CYCLES_NOW() at the first raw edge of the change
+};
+
+volatile inputEvent _input_queue[INPUT_QUEUE_SIZE];
+volatile unsigned char _input_head = 0; // written by the ISR
+volatile unsigned char _input_tail = 0; // written by INPUT_POP()
+
+// Debouncer, one bit per PORTC line
+volatile unsigned char _input_state = 0;    // debounced levels
+volatile unsigned char _input_pressed = 0;  // presses not taken yet
+volatile unsigned char _input_released = 0; // releases not taken yet
+unsigned char _input_count0 = 0, _input_count1 = 0, _input_count2 = 0; // vertical counter
+unsigned char _input_limit0, _input_limit1, _input_limit2; // per line sample count, same layout
+volatile unsigned char _input_settled = 0xFF; // raw level matched the state at the last sample
+volatile unsigned long _input_edge_time[8];  // first raw edge since the line was settled
+
+// Samples a line needs to read its new level before it counts, 1..7
+void INPUT_SET_DEBOUNCE(unsigned char line, unsigned char samples) {
+  unsigned char bit = (1 << line);
+  if (samples < 1) {
+    samples = 1;
+  }
+  if (samples > 7) {
+    samples = 7;
+  }
+  _input_limit0 = (samples & 1) ? (_input_limit0 | bit) : (_input_limit0 & ~bit);
+  _input_limit1 = (samples & 2) ? (_input_limit1 | bit) : (_input_limit1 & ~bit);
+  _input_limit2 = (samples & 4) ? (_input_limit2 | bit) : (_input_limit2 & ~bit);
+}
+
+void INPUT_INIT() {
+  DDRC &= ~INPUT_MASK;
+  for (unsigned char line = 0; line < 8; ++line) {
+    INPUT_SET_DEBOUNCE(line, INPUT_DEFAULT_SAMPLES);
+  }
+  _input_state = PINC & INPUT_MASK;
+
+  PCMSK1 |= INPUT_MASK;   // PCINT8.. are PC0..
+  PCIFR = (1 << PCIF1);
+  PCICR |= (1 << PCIE1);
+
+  // Timer0 CTC, 16 MHz / 256 / 125 = 500 Hz
+  TCCR0A = (1 << WGM01);
+  TCCR0B = (1 << CS02);
+  OCR0A = (F_CPU / 256 * INPUT_SAMPLE_MS / 1000) - 1;
+  TCNT0 = 0;
+  TIMSK0 |= (1 << OCIE0A);
+}
+
+// Debounced level of a line, true while the button is held
+bool INPUT_HELD(unsigned char line) {
+  return _input_state & (1 << line);
+}
+
+// True once for every debounced press of line
+bool INPUT_PRESSED(unsigned char line) {
+  unsigned char sreg = SREG;
+  cli();
+  bool pressed = _input_pressed & (1 << line);
+  _input_pressed &= ~(1 << line);
+  SREG = sreg;
+  return pressed;
+}
+
+// True once for every debounced release of line
+bool INPUT_RELEASED(unsigned char line) {
+  unsigned char sreg = SREG;
+  cli();
+  bool released = _input_released & (1 << line);
+  _input_released &= ~(1 << line);
+  SREG = sreg;
+  return released;
+}
+
+// Take the oldest event, false if there is none
+bool INPUT_POP(inputEvent &event) {
+  bool found = false;
+  unsigned char sreg = SREG;
+  cli();
+  if (_input_tail != _input_head) {
+    event.line = _input_queue[_input_tail].line;
+    event.pressed = _input_queue[_input_tail].pressed;
+    event.time = _input_queue[_input_tail].time;
+    _input_tail = (_input_tail + 1) & INPUT_QUEUE_MASK;
+    found = true;
+  }
+  SREG = sreg;
+  return found;
+}
+
+// Throw away everything queued so far
+void INPUT_CLEAR() {
+  unsigned char sreg = SREG;
+  cli();
+  _input_tail = _input_head;
+  SREG = sreg;
+}
+
+ISR(PCINT1_vect)
+{
+  unsigned long now = CYCLES_NOW();
+  unsigned char moved = ((PINC & INPUT_MASK) ^ _input_state) & _input_settled;
+  _input_settled &= ~moved;
+  for (unsigned char line = 0; moved; ++line, moved >>= 1) {
+    if (moved & 1) {
+      _input_edge_time[line] = now;
+    }
+  }
+}
+
+ISR(TIMER0_COMPA_vect)
+{
+  unsigned char sample = PINC & INPUT_MASK;
+  unsigned char differ = sample ^ _input_state;
+
+  // count up where the sample differs from the state, back to 0 where it doesn't
+  unsigned char carry0 = _input_count0 & differ;
+  unsigned char carry1 = _input_count1 & carry0;
+  _input_count0 = ~_input_count0 & differ;
+  _input_count1 = (_input_count1 ^ carry0) & differ;
+  _input_count2 = (_input_count2 ^ carry1) & differ;
+
+  unsigned char changed = differ & ~((_input_count0 ^ _input_limit0) | (_input_count1 ^ _input_limit1)
+                                     | (_input_count2 ^ _input_limit2));
+  _input_settled |= ~differ | changed;
+  if (!changed) {
+    return;
+  }
+
+  _input_state ^= changed;
+  _input_pressed |= changed & _input_state;
+  _input_released |= changed & ~_input_state;
+  _input_count0 &= ~changed;
+  _input_count1 &= ~changed;
+  _input_count2 &= ~changed;
+
+  for (unsigned char line = 0; changed; ++line, changed >>= 1) {
+    if (!(changed & 1)) {
+      continue;
+    }
+    unsigned char next = (_input_head + 1) & INPUT_QUEUE_MASK;
+    if (next == _input_tail) {
+      return; // full
+    }
+    _input_queue[_input_head].line = line;
+    _input_queue[_input_head].pressed = _input_state & (1 << line);
+    _input_queue[_input_head].time = _input_edge_time[line];
+    _input_head = next;
+  }
+}
+
+#endif // INPUT_H
@@ -1,1329 +1,69 @@
-#include <avr/io.h>
-#include <util/delay.h>
+#ifdef RENDER_BENCHMARK
+#define SPI_COUNT_BYTES // spi_bytes in its report
+#endif
+
+#include "hal.h"
+#include "gpio.h"
 #include "spi.h"
+#include "st7735.h"
+#include "font.h"
+#include "block.h"
+#include "displaylist.h"
+#include "align.h"
+#include "screen.h"
 #include "timer.h"
-
-#define LCD_CS PORTB2
-#define LCD_A0 PORTD7
-#define LCD_RESET PORTD6
-/*****************************************************************************/
-// Don't worry about the struct definitions---just look at the get and set functions
-
-struct B {
-    bool operator()(int pad) { return PINB & (1 << pad); } 
-    void operator()(int pad, bool value) { 
-        PORTB = (value) ? PORTB | (1 << pad) : PORTB & ~(1 << pad);
-    }
-};
-
-struct C {
-    bool operator()(int pad) { return PINC & (1 << pad); } 
-    void operator()(int pad, bool value) {
-        PORTC = (value) ? PORTC | (1 << pad) : PORTC & ~(1 << pad);
-    }
-};
-
-struct D {
-    bool operator()(int pad) { return PIND & (1 << pad); } 
-    void operator()(int pad, bool value) { 
-        PORTD = (value) ? PORTD | (1 << pad) : PORTD & ~(1 << pad);
-    }
-};
-
-// get function: fetches values from pin registers
-// Sample Usage:
-// get<B>(7) -- gets the value at PINB7 (returns 1 or 0)
-// get<D>(5) -- gets the value at PIND5 (returns 1 or 0)
-template <typename Group>
-bool get(int pad) {
-    return Group()(pad);
-}
-
-// set function: sets value at port regsiter
-// Note: This function DOES NOT disturb the other bits in the register
-// Sample Usage:
-// set<C>(5, 0) -- sets PORTC5 to 0
-// set<B>(6, 1) -- sets PORTC6 to 1
-// set<D>(7, true) -- sets PORTD7 to 1
-template <typename Group>
-void set(int pad, bool value) {
-    Group()(pad, value);
-}
-/*****************************************************************************/
-
-void cmd_st7735(unsigned char cmd) {
-  // TODO: set A0 pin LOW
-  set<D>(LCD_A0, 0);
-  // TODO: set CS pin LOW
-  set<B>(LCD_CS, 0);
-  SPI_SEND(cmd);
-  // TODO: set CS pin HIGH
-  set<B>(LCD_CS, 1);
-}
-
-void dat_st7735(unsigned char dat) {
-  // TODO: set A0 pin HIGH
-  set<D>(LCD_A0, 1);
-  // TODO: set CS pin LOW
-  set<B>(LCD_CS, 0);
-  SPI_SEND(dat);
-  // TODO: set CS pin HIGH
-  set<B>(LCD_CS, 1);
-}
-
-
-void HardwareReset(){
-  // TODO: set RESET pin LOW
-  set<D>(LCD_RESET, 0);
-  _delay_ms(200);
-  // TODO: set RESET pin HIGH
-  set<D>(LCD_RESET, 1);
-  _delay_ms(200);
-}
-
-void st7735_init(){
-  HardwareReset();
-  cmd_st7735(0x01); // SWRESET
-  _delay_ms(150);
-  cmd_st7735(0x11); // SLPOUT
-  _delay_ms(200);
-  cmd_st7735(0x3A); // COLMOD
-  dat_st7735(0x05);
-  _delay_ms(10);
-  cmd_st7735(0x29); // DISPON
-  _delay_ms(200);
+#include "cycles.h"
+#include "taskstats.h"
+#include "input.h"
+
+#ifdef SPI_BENCHMARK
+#include "spi_bench.h"
+#endif
+#ifdef SCHEDULER_REPORT
+#include "uart.h"
+#endif
+
+// Everything the game draws is queued on the display list and drawn between task
+// ticks, see displaylist.h
+
+// Solid color rectangle, corners inclusive. Only what isn't drawn over before it goes
+// out is sent (see st7735_fillRect())
+void fillRect(int xs, int xe, int ys, int ye, unsigned int color) {
+    dlFill(xs, xe, ys, ye, color);
 }
 
 void erase(int xStart, int xEnd, int yStart, int yEnd) {
-    unsigned int sizeX = (xEnd - xStart) + 1;
-    unsigned int sizeY = (yEnd - yStart) + 1;
-
-    cmd_st7735(0x2A); 
-    dat_st7735(xStart >> 8);
-    dat_st7735(xStart & 0xFF);
-    dat_st7735(xEnd >> 8);
-    dat_st7735(xEnd & 0xFF); 
-    
-    cmd_st7735(0x2B); 
-    dat_st7735(yStart >> 8);
-    dat_st7735(yStart & 0xFF);
-    dat_st7735(yEnd >> 8);
-    dat_st7735(yEnd & 0xFF); 
-
-    cmd_st7735(0x2C); 
-
-    for (unsigned int i = 0; i < sizeY; ++i) {
-      for (unsigned int j = 0; j < sizeX; ++j) {
-        dat_st7735(0xFF);
-        dat_st7735(0xFF);
-      }
-    }
-}
-
-void clearScreen() {
-    erase(0, 127, 0, 127);
-}
-
-void testLetter(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 2, 2, 2, 2, 2, 2, 0}, //10
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0},
-    {0, 2, 2, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 2, 2, 2, 2, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0}, //15
-    {0, 0, 0, 1, 1, 1, 1, 2, 2, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 2, 2, 2, 2, 2, 2, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 0, 0, 0},
-    {0, 1, 1, 1, 1, 1, 1, 0, 0, 0}, //20
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //30
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterT(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0}, //15    15
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //30    1
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterA(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 1, 1, 0, 0, 0, 1, 1, 0},
-    {0, 0, 1, 1, 0, 0, 0, 1, 1, 0},
-    {0, 0, 1, 1, 0, 0, 0, 1, 1, 0},
-    {0, 0, 1, 1, 0, 0, 0, 1, 1, 0},
-    {0, 0, 1, 1, 1, 1, 1, 1, 1, 0}, //15    15
-    {0, 0, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 0, 1, 1, 0, 0, 0, 1, 1, 0},
-    {0, 0, 1, 1, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //30    1
-  };
-
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterC(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0}, //15    15
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //30    1
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterK(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 0, 0, 1, 1, 0},
-    {0, 0, 0, 0, 0, 1, 1, 1, 1, 0}, //15    15
-    {0, 0, 0, 0, 0, 1, 1, 1, 1, 0},
-    {0, 0, 0, 1, 1, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //30    1
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterE(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0}, //15    15
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterR(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0}, //15    15
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //30    1
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterI(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0}, //15    15
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0},
-    {0, 1, 1, 1, 1, 1, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testLetterN(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 1, 1, 0, 0, 1, 1, 0}, //15    15
-    {0, 1, 1, 1, 1, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 1, 1, 1, 1, 0},
-    {0, 1, 1, 0, 0, 1, 1, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
+    fillRect(xStart, xEnd, yStart, yEnd, 0xFFFF);
 }
 
-void testLetterO(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0}, //15    15
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
+// The tower is drawn into a ring of TOWER_BANDS bands in frame memory, and the panel's
+// vertical scrolling moves the view up it once it is taller than the screen (see
+// towerShowBand()). Row 0 is the bottom of the screen; ring lines past the 128 on the
+// glass are where the next band is prepared before it scrolls in.
+#define BAND_HEIGHT 13
+#define TOWER_BANDS 12
+#define TOWER_ROWS (TOWER_BANDS * BAND_HEIGHT) // 156 of the ST7735_FRAME_ROWS
+#define SCREEN_ROWS 128
 
-void testLetterG(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 0, 0, 0, 0, 1, 1, 0},
-    {0, 1, 1, 1, 1, 0, 0, 1, 1, 0}, //15    15
-    {0, 1, 1, 1, 1, 0, 0, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 1, 1, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0},
-    {0, 0, 0, 1, 1, 1, 1, 0, 0, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
+unsigned char towerScroll = 0; // ring line on the bottom row of the screen
 
-void testLetterM(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 1, 1, 0, 0, 1, 1}, //15    15
-    {1, 1, 0, 0, 1, 1, 0, 0, 1, 1},
-    {1, 1, 1, 1, 0, 0, 1, 1, 1, 1},
-    {1, 1, 1, 1, 0, 0, 1, 1, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-void testLetterV(int letterXS, int letterXE, int letterYS, int letterYE) {
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 0, 0, 1, 1, 0, 0, 0, 0},
-    {0, 0, 1, 1, 0, 0, 1, 1, 0, 0},
-    {0, 0, 1, 1, 0, 0, 1, 1, 0, 0}, //15    15
-    {0, 0, 1, 1, 0, 0, 1, 1, 0, 0},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 1, 1}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x00); //black
-        dat_st7735(0x00);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
+void clearScreen() {
+    if (towerScroll) {
+        towerScroll = 0;
+        dlScroll(0);
     }
-    
-  }
+    fillRect(0, 127, 0, 127, 0xFFFF);
+    screenInvalidate();
 }
 
-void testConfettiBlue(int letterXS, int letterXE, int letterYS, int letterYE) {
-  clearScreen();
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //15    15
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0xB9); //black
-        dat_st7735(0xA4);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
+#define CONFETTI_BLUE 0xB9A4
+#define CONFETTI_RED 0x83FF
+#define CONFETTI_GREEN 0x4FA3
+#define CONFETTI_YELLOW 0x4FF9
 
-void testConfettiRed(int letterXS, int letterXE, int letterYS, int letterYE) {
+void drawConfetti(int x, int y, unsigned int color) {
   clearScreen();
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //15    15
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x83);
-        dat_st7735(0xFF);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testConfettiGreen(int letterXS, int letterXE, int letterYS, int letterYE) {
-  clearScreen();
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //15    15
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x4F);
-        dat_st7735(0xA3);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
-}
-
-void testConfettiYellow(int letterXS, int letterXE, int letterYS, int letterYE) {
-  clearScreen();
-  unsigned int sizeX = (letterXE - letterXS) + 1;
-  unsigned int sizeY = (letterYE - letterYS) + 1;
-
-  unsigned int charS[30][10] = {
-    
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //5
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, //10    20
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //15    15
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0},
-    {0, 0, 0, 0, 0, 0, 1, 1, 1, 0}, //20    10
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0}, //25    5
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 1, 1, 1, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-  };
-
-  
-
-  cmd_st7735(0x2A);
-  dat_st7735(letterXS >> 8);
-  dat_st7735(letterXS & 0xFF);
-  dat_st7735((letterXE) >> 8);
-  dat_st7735((letterXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(letterYS >> 8);
-  dat_st7735(letterYS & 0xFF);
-  dat_st7735((letterYE) >> 8);
-  dat_st7735((letterYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  // 2. enter a loop:
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (charS[i][j] == 1) {
-        dat_st7735(0x4F);
-        dat_st7735(0xF9);
-      }
-      else {
-        dat_st7735(0xFF); //white
-        dat_st7735(0xFF);
-      }
-    }
-    
-  }
+  dlGlyph(x, y, '*', color, 0xFFFF);
 }
 
 /* GLOBAL VARIABLES */
@@ -1337,175 +77,114 @@ unsigned char blockNum = 3;
 unsigned char level = 1;
 unsigned char prevBlockXS = 48;
 unsigned char prevBlockXE = 83;
-unsigned char speed = 7;
 
 
-void drawFirstBlock(int blockXS, int blockXE, int blockYS, int blockYE) {
+// 12 px cells with a 2 px border, the 13th row of a band is the gap to the next one
+const blockStyle towerBlock = {12, 2, 0x83FF, 0xB4FF, 0xFFFF};
+
+// Level the game is won at, 0 to keep stacking for as long as the drops land
+#ifndef WIN_LEVEL
+#define WIN_LEVEL 0
+#endif
+
+// Move yS/yE one band up the tower, round the ring
+void towerNextBand() {
+  yS = (yS + BAND_HEIGHT) % TOWER_ROWS;
+  yE = yS + BAND_HEIGHT - 1;
+}
+
+// Get the band at yS ready for the moving block: wipe what an earlier lap round the
+// ring left there and, if it is above the top of the screen, scroll it into the top
+// row. Only this band is drawn; the rest of the tower moves with the scroll.
+void towerShowBand() {
   erase(0, 128, yS, yE);
-  unsigned int sizeX = (blockXE - blockXS) + 1;
-  unsigned int sizeY = (blockYE - blockYS) + 1;
-
-  unsigned int block[12][36] = {
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(blockXS >> 8);
-  dat_st7735(blockXS & 0xFF);
-  dat_st7735((blockXE) >> 8);
-  dat_st7735((blockXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(blockYS >> 8);
-  dat_st7735(blockYS & 0xFF);
-  dat_st7735((blockYE) >> 8);
-  dat_st7735((blockYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (block[i][j] == 1) {
-        dat_st7735(0x83);
-        dat_st7735(0xFF);
-      }
-      else {
-        dat_st7735(0xB4); 
-        dat_st7735(0xFF);
-      }
-    }
+  unsigned char height = (yE + 1 + TOWER_ROWS - towerScroll) % TOWER_ROWS; // bottom row to the band's top
+  if (height == 0 || height > SCREEN_ROWS) {
+    towerScroll = (yE + 1 + TOWER_ROWS - SCREEN_ROWS) % TOWER_ROWS;
+    dlScroll(towerScroll);
   }
 }
 
-void draw2Block(int blockXS, int blockXE, int blockYS, int blockYE) {
+void drawFirstBlock(int blockXS, int blockXE, int blockYS, int blockYE) {
   erase(0, 128, yS, yE);
-  unsigned int sizeX = (blockXE - blockXS) + 1;
-  unsigned int sizeY = (blockYE - blockYS) + 1;
-
-  unsigned int block[12][28] = {
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(blockXS >> 8);
-  dat_st7735(blockXS & 0xFF);
-  dat_st7735((blockXE) >> 8);
-  dat_st7735((blockXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(blockYS >> 8);
-  dat_st7735(blockYS & 0xFF);
-  dat_st7735((blockYE) >> 8);
-  dat_st7735((blockYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (block[i][j] == 1) {
-        dat_st7735(0x83);
-        dat_st7735(0xFF);
-      }
-      else {
-        dat_st7735(0xB4); 
-        dat_st7735(0xFF);
-      }
-    }
-  }
+  dlBlock(blockXS, blockXE, blockYS, blockYE, towerBlock);
 }
 
 void drawBlock(int blockXS, int blockXE, int blockYS, int blockYE) {
-  unsigned int sizeX = (blockXE - blockXS) + 1;
-  unsigned int sizeY = (blockYE - blockYS) + 1;
-
-  unsigned int block[12][36] = {
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
-    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}
-  };
-
-  cmd_st7735(0x2A);
-  dat_st7735(blockXS >> 8);
-  dat_st7735(blockXS & 0xFF);
-  dat_st7735((blockXE) >> 8);
-  dat_st7735((blockXE) & 0xFF);
-
-  // RASET
-  // 1. Send RASET command -- look at the datasheet
-  cmd_st7735(0x2B);
-  dat_st7735(blockYS >> 8);
-  dat_st7735(blockYS & 0xFF);
-  dat_st7735((blockYE) >> 8);
-  dat_st7735((blockYE) & 0xFF);
-
-  // RAMWR
-  // 1. Send RAMWR command -- look at the datasheet
-  cmd_st7735(0x2C);
-  
-  for (unsigned int i = 0; i < sizeY; ++i) {
-    for (unsigned int j = 0; j < sizeX; ++j) {
-      if (block[i][j] == 1) {
-        dat_st7735(0x83);
-        dat_st7735(0xFF);
-      }
-      else {
-        dat_st7735(0xB4); 
-        dat_st7735(0xFF);
-      }
-    }
-  }
+  dlBlock(blockXS, blockXE, blockYS, blockYE, towerBlock);
 }
 
-enum moveStates {init, moveRight, moveLeft, waitMoveLeft, waitMoveRight};
+enum moveStates {init, moveRight, moveLeft};
 int tickFctMove(int state);
 
-unsigned char timer;
+// Block speed per level in 1/256 px per move tick (5 ms); levels past the end keep
+// the last entry. Levels 1-8 match the old tick-counting speeds (1/8 .. 1/3 px a
+// tick). Capped at one pixel a tick so every step stays an incremental sprite move.
+#define MOVE_LEVELS 16
+const unsigned int moveVelocity[MOVE_LEVELS] PROGMEM = {
+  32, 32, 32, 37, 43, 51, 64, 85,
+  96, 110, 128, 146, 171, 192, 224, 256
+};
+
+// Sub-pixel part of the block position, in 1/256 px. xS/xE hold the whole pixels,
+// so the rest of the game keeps reading and adjusting those as before.
+unsigned char moveFrac;
+
+// Advance the sub-pixel position by one tick at the current level's speed and
+// return whether the block crossed into the next pixel
+bool moveAdvance() {
+  unsigned char n = (level > MOVE_LEVELS) ? MOVE_LEVELS : level;
+  unsigned int next = moveFrac + pgm_read_word(&moveVelocity[n - 1]);
+  moveFrac = next & 0xFF;
+  return next > 0xFF;
+}
+
+blockSprite movingBlock = {0, 0, 0, 0, false};
+
+// Where the moving block was over its last few steps, so a button press can be
+// matched to what was on screen when it happened. xS/xE are stored the way
+// tickFctCheckPress sees them, i.e. after the step's update.
+#define MOVE_HISTORY_SIZE 8
+struct movePosition {
+  unsigned long time; // CYCLES_NOW() when the step was queued
+  unsigned char xS;
+  unsigned char xE;
+};
+movePosition moveHistory[MOVE_HISTORY_SIZE];
+unsigned char moveHistoryNext = 0;
+unsigned char moveHistoryCount = 0;
+
+void moveHistoryAdd(unsigned long time, unsigned char blockXS, unsigned char blockXE) {
+  moveHistory[moveHistoryNext].time = time;
+  moveHistory[moveHistoryNext].xS = blockXS;
+  moveHistory[moveHistoryNext].xE = blockXE;
+  moveHistoryNext = (moveHistoryNext + 1) % MOVE_HISTORY_SIZE;
+  if (moveHistoryCount < MOVE_HISTORY_SIZE) {
+    ++moveHistoryCount;
+  }
+}
+
+void moveHistoryClear() {
+  moveHistoryCount = 0;
+}
+
+// Position at time, newest step drawn at or before it. Leaves blockXS/blockXE alone
+// if there is no history; if time is older than everything kept, the oldest wins.
+void moveHistoryAt(unsigned long time, unsigned char &blockXS, unsigned char &blockXE) {
+  for (unsigned char n = 1; n <= moveHistoryCount; ++n) {
+    const movePosition &step = moveHistory[(moveHistoryNext + MOVE_HISTORY_SIZE - n) % MOVE_HISTORY_SIZE];
+    blockXS = step.xS;
+    blockXE = step.xE;
+    if ((long)(time - step.time) >= 0) {
+      return;
+    }
+  }
+}
 int tickFctMove(int state) {
   
   switch(state) {
     case init:
-      timer = 0;
-      yS = yS + 13;
-      yE = yE + 13;
+      towerNextBand();
       xE = 128;
       if ((gamePlaying == true)) {
         state = moveRight;
@@ -1517,13 +196,8 @@ int tickFctMove(int state) {
 
     case moveRight:
       if (xS == 0) {
-        timer = 0;
         state = moveLeft;
       }
-      if (xS > 0) {
-        timer = 0;
-        state = waitMoveRight;
-      }
       if ((gamePlaying == false)) {
         clearScreen();
         state = init;
@@ -1532,43 +206,14 @@ int tickFctMove(int state) {
 
     case moveLeft:
       if (xE == 127) {
-        timer = 0;
         state = moveRight;
       }
-      if (xE < 127) {
-        timer = 0;
-        state = waitMoveLeft;
-      }
       if ((gamePlaying == false)) {
         clearScreen();
         state = init;
       }
       break;
 
-    case waitMoveLeft:
-      if (timer < speed) {
-        timer++;
-        state = waitMoveLeft;
-      }
-      if (timer >= speed) {
-        timer = 0;
-        state = moveLeft;
-      }
-      
-      break;
-
-    case waitMoveRight:
-      if (timer < speed) {
-        timer++;
-        state = waitMoveRight;
-      }
-      if (timer >= speed) {
-        timer = 0;
-        state = moveRight;
-      }
-      
-      break;
-
     default:
       state = init;
       break;
@@ -1578,28 +223,27 @@ int tickFctMove(int state) {
   switch(state) {
     case init:
       xE = 127;
+      moveFrac = 0xFF; // first tick of play steps, and so draws, straight away
+      movingBlock.drawn = false;
+      moveHistoryClear();
       break;
 
     case moveRight:
-      erase((xE + 1), (xE + 1), yS, yE);
-      drawBlock(xS, xE, yS, yE);
-      xS = xS - 1;
-      xE = xE - 1;
-      timer = 0;
+      if (moveAdvance()) {
+        moveBlockSprite<dlDraw>(movingBlock, xS, xE, yS, yE, towerBlock);
+        xS = xS - 1;
+        xE = xE - 1;
+        moveHistoryAdd(CYCLES_NOW(), xS, xE);
+      }
       break;
 
     case moveLeft:
-      erase((xS - 1), (xS - 1), yS, yE);
-      drawBlock(xS, xE, yS, yE);
-      xS = xS + 1;
-      xE = xE + 1;
-      timer = 0;
-      break;
-
-    case waitMoveLeft:
-      break;
-
-    case waitMoveRight:
+      if (moveAdvance()) {
+        moveBlockSprite<dlDraw>(movingBlock, xS, xE, yS, yE, towerBlock);
+        xS = xS + 1;
+        xE = xE + 1;
+        moveHistoryAdd(CYCLES_NOW(), xS, xE);
+      }
       break;
 
     default:
@@ -1611,270 +255,62 @@ int tickFctMove(int state) {
 enum checkPress {waitPress, buttonPressed, checkAlign};
 int tickFctCheckPress(int state);
 
-unsigned char pressed;
+#define TOWER_CELL 12 // block cells sit on a 12 px grid, the base is cells 4..6
+#define ALIGN_TOLERANCE 4 // px a drop may be off and still keep a cell
+
+unsigned long pressTime; // when the place button went down, CYCLES_NOW() time
 int tickFctCheckPress(int state) {
+  inputEvent event;
   switch(state) {
     case waitPress:
-      if (get<C>(0) == 0) {
-        state = waitPress;
-      }
-      if ((get<C>(0) == 1) && (gamePlaying == true)) {
-        pressed = 0;
-        state = buttonPressed;
+      while (INPUT_POP(event)) {
+        if ((event.line == BUTTON_PLACE) && event.pressed && (gamePlaying == true)) {
+          pressTime = event.time;
+          state = checkAlign;
+          break;
+        }
       }
       break;
 
     case buttonPressed:
-      if (get<C>(0) == 0) {
-        state = buttonPressed;
+      // wait for the button to come back up before taking the next press
+      while (INPUT_POP(event)) {
+        if ((event.line == BUTTON_PLACE) && !event.pressed) {
+          state = waitPress;
+        }
       }
-      if (get<C>(0) == 1) {
-        pressed = 1;
-        state = checkAlign;
+      if (!INPUT_HELD(BUTTON_PLACE)) {
+        state = waitPress;
       }
       break;
     
     case checkAlign:
-      if (get<C>(0) == 0) {
-        pressed = 0;
-        
-        if (blockNum == 3) {
-          // 83   48    3 blocks
-          // 83   60    2 block left side
-          // 71   48    2 block right side
-          // 59   48    1 block right side
-          // 83   72    1 block left side
-          // 71   60
-          // check alignment and account if too far right or too far left (~3 pixels max)
-          // perfect block alignment
-          if (((xS >= 45) && (xE <= 86))) {
-            drawFirstBlock(48, 83, (yS), (yE));
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 48;
-            prevBlockXE = 83;
-            blockNum = 3;
+      // judge the drop from where the block was when the button went down,
+      // not from where it got to by the time this task ran
+      moveHistoryAt(pressTime, xS, xE);
+      moveHistoryClear();
+
+      {
+        unsigned char firstCell, lastCell;
+        if (alignResolve(alignCells(prevBlockXS, prevBlockXE, TOWER_CELL, 0), xS, xE,
+                         TOWER_CELL, ALIGN_TOLERANCE, firstCell, lastCell)) {
+          unsigned char kept = (lastCell - firstCell) + 1;
+          prevBlockXS = firstCell * TOWER_CELL;
+          prevBlockXE = ((lastCell + 1) * TOWER_CELL) - 1;
+          drawFirstBlock(prevBlockXS, prevBlockXE, (yS), (yE));
+          xS = xS + ((blockNum - kept) * TOWER_CELL); // the moving block loses what fell off
+          towerNextBand();
+          towerShowBand();
+          blockNum = kept;
+          if (level < 255) {
             ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            
           }
-          // too far right by 1 block
-          else if (xS >= 34 && xS <= 44) {
-            drawFirstBlock(48, 71, (yS), (yE));
-            xS = xS + 12;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 48;
-            prevBlockXE = 71;
-            blockNum = 2;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-          }
-          // too far left by 1 block
-          else if (xE >= 87 && xE <= 98) {
-            drawFirstBlock(60, 83, (yS), (yE));
-            xS = xS + 12;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 60;
-            prevBlockXE = 83;
-            blockNum = 2;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-          }
-          // too far right by 2 blocks
-          else if (xS >= 20 && xS <= 33) {
-            drawFirstBlock(48, 59, (yS), (yE));
-            xS = xS + 24;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 48;
-            prevBlockXE = 59;
-            blockNum = 1;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-          }
-          // too far left by 2 blocks
-          else if (xE >= 99 && xE <= 109) {
-            drawFirstBlock(72, 83, (yS), (yE));
-            xS = xS + 24;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 72;
-            prevBlockXE = 83;
-            blockNum = 1;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-          }
-          else {
-              gameOver = true;
-            }
         }
-
-        else if (blockNum == 2) {
-          // perfect alignment 
-          if ((prevBlockXS == 48) && (prevBlockXE == 71)) {
-            if (((xS >= 43) && (xE <= 75))) {
-            drawFirstBlock(48, 71, (yS), (yE));
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 48;
-            prevBlockXE = 71;
-            blockNum = 2;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            //far right
-            else if (xS >= 34 && xS <= 42) {
-            drawFirstBlock(48, 59, (yS), (yE));
-            xS = xS + 12;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 48;
-            prevBlockXE = 59;
-            blockNum = 1;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            //far left (middle block)
-            else if (xE >= 72 && xE <= 85) {
-            drawFirstBlock(60, 71, (yS), (yE));
-            xS = xS + 12;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 60;
-            prevBlockXE = 71;
-            blockNum = 1;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            else {
-              gameOver = true;
-            }
-          }
-
-          else if ((prevBlockXS == 60) && (prevBlockXE == 83)) {
-            // perfect alignment 
-            if (((xS >= 56) && (xE <= 87))) {
-            drawFirstBlock(60, 83, (yS), (yE));
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 60;
-            prevBlockXE = 83;
-            blockNum = 2;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            //far left
-            else if ((xE >= 86) && (xE <= 98)) {
-            drawFirstBlock(72, 83, (yS), (yE));
-            xS = xS + 12;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 72;
-            prevBlockXE = 83;
-            blockNum = 1;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            //far right (middle) 
-            else if ((xS >= 46) && (xS <= 59)) {
-            drawFirstBlock(60, 71, (yS), (yE));
-            xS = xS + 12;
-            yS = yS + 13;
-            yE = yE + 13;
-            prevBlockXS = 60;
-            prevBlockXE = 71;
-            blockNum = 1;
-            ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            else {
-              gameOver = true;
-            }
-          }
+        else {
+          gameOver = true;
         }
-
-        else if (blockNum == 1) {
-          if ((prevBlockXS == 60) && (prevBlockXE == 71)) {
-            if (((xS >= 56) && (xE <= 74))) {
-              drawFirstBlock(60, 71, (yS), (yE));
-              yS = yS + 13;
-              yE = yE + 13;
-              prevBlockXS = 60;
-              prevBlockXE = 71;
-              blockNum = 1;
-              ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            else {
-              gameOver = true;
-            }
-          }
-          else if ((prevBlockXS == 72) && (prevBlockXE == 83)) {
-            if (((xS >= 68) && (xE <= 86))) {
-              drawFirstBlock(72, 83, (yS), (yE));
-              yS = yS + 13;
-              yE = yE + 13;
-              prevBlockXS = 72;
-              prevBlockXE = 83;
-              blockNum = 1;
-              ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            else {
-              gameOver = true;
-            }
-          }
-          else if ((prevBlockXS == 48) && (prevBlockXE == 59)) {
-            if (((xS >= 43) && (xE <= 63))) {
-              drawFirstBlock(48, 59, (yS), (yE));
-              yS = yS + 13;
-              yE = yE + 13;
-              prevBlockXS = 48;
-              prevBlockXE = 59;
-              blockNum = 1;
-              ++level;
-            if (level >= 4 && level <= 8) {
-              speed -= 1;
-            }
-            }
-            else {
-              gameOver = true;
-            }
-          }
-        }
-        
-      }
-      if (pressed == 0) {
-        state = waitPress;
       }
+      state = buttonPressed;
       break;
 
     default:
@@ -1897,22 +333,70 @@ int tickFctCheckPress(int state) {
   return state;
 }
 
+void drawTitleScreen() {
+  dlString(109, 96, "STACKERINO", 0x0000, 0xFFFF);
+}
+
+// base of the tower, the moving rows are drawn by tickFctMove/tickFctCheckPress
+void drawPlayScreen() {
+  drawBlock(48, 83, 0, 12);
+}
+
+void drawLoseScreen() {
+  dlString(79, 86, "GAME", 0x0000, 0xFFFF);
+  dlString(79, 61, "OVER", 0x0000, 0xFFFF);
+}
+
+void drawWinScreen() {
+  drawConfetti(109, 96, CONFETTI_BLUE);
+  drawConfetti(100, 96, CONFETTI_RED);
+  drawConfetti(90, 96, CONFETTI_GREEN);
+  drawConfetti(80, 96, CONFETTI_YELLOW);
+  drawConfetti(70, 96, CONFETTI_BLUE);
+  drawConfetti(60, 96, CONFETTI_RED);
+  drawConfetti(50, 96, CONFETTI_GREEN);
+  drawConfetti(40, 96, CONFETTI_YELLOW);
+
+  drawConfetti(109, 76, CONFETTI_BLUE);
+  drawConfetti(100, 76, CONFETTI_RED);
+  drawConfetti(90, 76, CONFETTI_GREEN);
+  drawConfetti(80, 76, CONFETTI_YELLOW);
+  drawConfetti(70, 76, CONFETTI_BLUE);
+  drawConfetti(60, 76, CONFETTI_RED);
+  drawConfetti(50, 76, CONFETTI_GREEN);
+  drawConfetti(40, 76, CONFETTI_YELLOW);
+
+  drawConfetti(109, 56, CONFETTI_BLUE);
+  drawConfetti(100, 56, CONFETTI_RED);
+  drawConfetti(90, 56, CONFETTI_GREEN);
+  drawConfetti(80, 56, CONFETTI_YELLOW);
+  drawConfetti(70, 56, CONFETTI_BLUE);
+  drawConfetti(60, 56, CONFETTI_RED);
+  drawConfetti(50, 56, CONFETTI_GREEN);
+  drawConfetti(40, 56, CONFETTI_YELLOW);
+}
+
 enum mainMenu {menuIdle, startPressed, resetPressed, startGame, loseGame, winGame};
 int tickFctMenu(int state);
 
+bool panelReady = false; // the panel takes pixels, set by tickFctPanel
+
 int tickFctMenu(int state) {
+  if (!panelReady) {
+    return state; // nothing to draw on yet
+  }
   switch(state) {
     case menuIdle:
-      if (get<C>(1) == 1) {
+      if (INPUT_HELD(BUTTON_START)) {
         state = startPressed;
       }
       break;
 
     case startPressed:
-      if (get<C>(1) == 1) {
+      if (INPUT_HELD(BUTTON_START)) {
         state = startPressed;
       }
-      if (get<C>(1) == 0) {
+      if (!INPUT_HELD(BUTTON_START)) {
         gamePlaying = true;
         clearScreen();
         yS = 0;
@@ -1924,27 +408,29 @@ int tickFctMenu(int state) {
       break;
 
     case startGame:
-      if (get<C>(1) == 0) {
+      if (!INPUT_HELD(BUTTON_START)) {
         state = startGame;
       }
-      if (get<C>(1) == 1) {
+      if (INPUT_HELD(BUTTON_START)) {
         state = resetPressed;
       }
       if (gameOver == true) {
         gamePlaying = false;
         state = loseGame;
       }
-      if (level >= 10) {
+#if WIN_LEVEL
+      if (level >= WIN_LEVEL) {
         gamePlaying = false;
         state = winGame;
       }
+#endif
       break;
 
     case resetPressed:
-      if (get<C>(1) == 1 || get<C>(0) == 1) {
+      if (INPUT_HELD(BUTTON_START) || INPUT_HELD(BUTTON_PLACE)) {
         state = resetPressed;
       }
-      if (get<C>(1) == 0 || get<C>(0) == 0) {
+      if (!INPUT_HELD(BUTTON_START) || !INPUT_HELD(BUTTON_PLACE)) {
         clearScreen();
         gamePlaying = 0;
         xS = 92; 
@@ -1954,7 +440,7 @@ int tickFctMenu(int state) {
         blockNum = 3;
         level = 1;
         prevBlockXS = 48;
-        speed = 7;
+        prevBlockXE = 83;
         gameOver = false;
         state = menuIdle;
       }
@@ -1962,19 +448,19 @@ int tickFctMenu(int state) {
       break;
     
     case loseGame:
-      if (get<C>(0) == 0) {
+      if (!INPUT_HELD(BUTTON_PLACE)) {
         state = loseGame;
       }
-      if (get<C>(0) == 1) {
+      if (INPUT_HELD(BUTTON_PLACE)) {
         state = resetPressed;
       }
       break;
 
     case winGame:
-      if (get<C>(0) == 0) {
+      if (!INPUT_HELD(BUTTON_PLACE)) {
         state = winGame;
       }
-      if (get<C>(0) == 1) {
+      if (INPUT_HELD(BUTTON_PLACE)) {
         state = resetPressed;
       }
       break;
@@ -1986,63 +472,20 @@ int tickFctMenu(int state) {
   switch(state) {
     case menuIdle:
       gamePlaying = false;
-        testLetter(109, 118, 96, 125);
-        testLetterT(100, 109, 96, 125);
-        testLetterA(90, 99, 96, 125);
-        testLetterC(80, 89, 96, 125);
-        testLetterK(70, 79, 96, 125);
-        testLetterE(60, 69, 96, 125);
-        testLetterR(50, 59, 96, 125);
-        testLetterI(40, 49, 96, 125);
-        testLetterN(30, 39, 96, 125);
-        testLetterO(20, 29, 96, 125);
+      screenShow(SCREEN_TITLE, drawTitleScreen);
       break;
     case startPressed:
       break;
     case startGame:
-      drawBlock(48, 83, 0, 12);
+      screenShow(SCREEN_PLAY, drawPlayScreen);
       break;
     case resetPressed:
       break;
     case loseGame:
-      testLetterG(79, 88, 86, 115);
-      testLetterA(69, 78, 86, 115);
-      testLetterM(59, 68, 86, 115);
-      testLetterE(49, 58, 86, 115);
-
-      testLetterO(79, 88, 61, 90);
-      testLetterV(69, 78, 61, 90);
-      testLetterE(59, 68, 61, 90);
-      testLetterR(49, 58, 61, 90);
+      screenShow(SCREEN_LOSE, drawLoseScreen);
       break;
-    case winGame: // put into while/if loop
-      testConfettiBlue(109, 118, 96, 125);
-      testConfettiRed(100, 109, 96, 125);
-      testConfettiGreen(90, 99, 96, 125);
-      testConfettiYellow(80, 89, 96, 125);
-      testConfettiBlue(70, 79, 96, 125);
-      testConfettiRed(60, 69, 96, 125);
-      testConfettiGreen(50, 59, 96, 125);
-      testConfettiYellow(40, 49, 96, 125);
-
-      testConfettiBlue(109, 118, 76, 105);
-      testConfettiRed(100, 109, 76, 105);
-      testConfettiGreen(90, 99, 76, 105);
-      testConfettiYellow(80, 89, 76, 105);
-      testConfettiBlue(70, 79, 76, 105);
-      testConfettiRed(60, 69, 76, 105);
-      testConfettiGreen(50, 59, 76, 105);
-      testConfettiYellow(40, 49, 76, 105);
-
-      testConfettiBlue(109, 118, 56, 85);
-      testConfettiRed(100, 109, 56, 85);
-      testConfettiGreen(90, 99, 56, 85);
-      testConfettiYellow(80, 89, 56, 85);
-      testConfettiBlue(70, 79, 56, 85);
-      testConfettiRed(60, 69, 56, 85);
-      testConfettiGreen(50, 59, 56, 85);
-      testConfettiYellow(40, 49, 56, 85);
-      
+    case winGame: // confetti animation, replayed every tick so not a retained screen
+      drawWinScreen();
       break;
     default:
       break;
@@ -2052,59 +495,255 @@ int tickFctMenu(int state) {
 
 typedef struct _task{
   signed char state; //Task's current state
-  unsigned long period; //Task period
-  unsigned long elapsedTime; //Time elapsed since last task tick
+  unsigned long period; //Task period, in timer ticks (see timer.h)
+  unsigned long nextTime; //When the task is due next
+  unsigned long lastTime; //When it last ran
+  unsigned long actualPeriod; //Time between its last two ticks
+  unsigned long maxPeriod; //Longest time between two ticks so far
+  taskStats stats; //Execution time, missed deadlines and jitter
   int (*TickFct)(int); //Task tick function
 } task;
 
-task tasks[3];
+#define TASKS_NUM 4
+task tasks[TASKS_NUM];
+
+// Display bring-up as a task, so the datasheet waits pass in the scheduler instead of
+// in _delay_ms. Each step sets the task's own period to the wait before the next one.
+// Frame memory is cleared while the panel is still asleep and the display only goes
+// on once the first screen is drawn, so the title appears whole at the earliest moment
+// the datasheet allows.
+#define PANEL_TASK 3 // index in tasks[]
+#define PANEL_IDLE_PERIOD TIMER_MS_TO_TICKS(1000) // once the display is on
+
+enum panelStates {panelOff, panelReset, panelWake, panelSetup, panelSleepOut, panelWaitFrame, panelOn};
+int tickFctPanel(int state);
+
+unsigned long panelResetTime; // when RESX went high
+unsigned long bootTicks = 0;  // TimerOn() to the display going on, 0 until then
+
+int tickFctPanel(int state) {
+  switch(state) {
+    case panelOff:
+      state = panelReset;
+      break;
+    case panelReset:
+      state = panelWake;
+      break;
+    case panelWake:
+      state = panelSetup;
+      break;
+    case panelSetup:
+      state = panelSleepOut;
+      break;
+    case panelSleepOut:
+      state = panelWaitFrame;
+      break;
+    case panelWaitFrame:
+      if (screenOnPanel != SCREEN_NONE && dlIdle()) { // queued and also drawn
+        st7735_displayOn();
+        bootTicks = TimerNow();
+        state = panelOn;
+      }
+      break;
+    case panelOn:
+      break;
+    default:
+      state = panelOff;
+      break;
+  }
+  switch(state) {
+    case panelReset:
+      st7735_resetBegin();
+      tasks[PANEL_TASK].period = 1; // one tick is 64 us, well over ST7735_RESET_PULSE_US
+      break;
+    case panelWake:
+      st7735_resetEnd();
+      panelResetTime = TimerNow();
+      tasks[PANEL_TASK].period = TIMER_MS_TO_TICKS(ST7735_RESET_WAIT_MS);
+      break;
+    case panelSetup:
+      st7735_setup();
+      st7735_scrollArea(0, TOWER_ROWS, ST7735_FRAME_ROWS - TOWER_ROWS);
+      clearScreen();
+      panelReady = true;
+      {
+        // SLPOUT no earlier than ST7735_SLPOUT_AFTER_RESET_MS after the reset; the
+        // period counts from when this step was due, not from now
+        unsigned long sleepOut = panelResetTime + TIMER_MS_TO_TICKS(ST7735_SLPOUT_AFTER_RESET_MS);
+        long wait = (long)(sleepOut - tasks[PANEL_TASK].nextTime);
+        tasks[PANEL_TASK].period = (wait > 0) ? wait : 1;
+      }
+      break;
+    case panelSleepOut:
+      st7735_sleepOut();
+      tasks[PANEL_TASK].period = TIMER_MS_TO_TICKS(ST7735_SLPOUT_WAIT_MS);
+      break;
+    case panelWaitFrame:
+      tasks[PANEL_TASK].period = TIMER_MS_TO_TICKS(1);
+      break;
+    case panelOn:
+      tasks[PANEL_TASK].period = PANEL_IDLE_PERIOD;
+      break;
+    default:
+      break;
+  }
+  return state;
+}
+
+#ifdef SCHEDULER_REPORT
+// Periods and execution statistics of every task, build with -DSCHEDULER_REPORT
+// and read it on the serial monitor. Printed every 2 s and whenever a byte is
+// received. Periods and jitter are in us, tick durations in CPU cycles. boot_us is
+// how long the display took to come on with the first screen, 0 if it hasn't yet.
+void schedulerReport() {
+  for (unsigned char i = 0; i < TASKS_NUM; ++i) {
+    UART_PRINT("task=");
+    UART_PRINT_NUM(i);
+    UART_PRINT(" period_us=");
+    UART_PRINT_NUM(TIMER_TICKS_TO_US(tasks[i].period));
+    UART_PRINT(" actual_us=");
+    UART_PRINT_NUM(TIMER_TICKS_TO_US(tasks[i].actualPeriod));
+    UART_PRINT(" max_us=");
+    UART_PRINT_NUM(TIMER_TICKS_TO_US(tasks[i].maxPeriod));
+    UART_PRINT(" runs=");
+    UART_PRINT_NUM(tasks[i].stats.runs);
+    UART_PRINT(" last_cycles=");
+    UART_PRINT_NUM(tasks[i].stats.lastCycles);
+    UART_PRINT(" avg_cycles=");
+    UART_PRINT_NUM(taskStatsAverage(tasks[i].stats));
+    UART_PRINT(" max_cycles=");
+    UART_PRINT_NUM(tasks[i].stats.maxCycles);
+    UART_PRINT(" missed=");
+    UART_PRINT_NUM(tasks[i].stats.missed);
+    UART_PRINT(" jitter_us=");
+    UART_PRINT_NUM(TIMER_TICKS_TO_US(tasks[i].stats.lastJitter));
+    UART_PRINT(" max_jitter_us=");
+    UART_PRINT_NUM(TIMER_TICKS_TO_US(tasks[i].stats.maxJitter));
+    UART_PRINT("\r\n");
+  }
+  UART_PRINT("boot_us=");
+  UART_PRINT_NUM(TIMER_TICKS_TO_US(bootTicks));
+  UART_PRINT(" draw_stalls=");
+  UART_PRINT_NUM(dlStalls);
+  UART_PRINT("\r\n");
+}
+#endif
+
+#ifdef RENDER_BENCHMARK
+#include "render_bench.h"
+#endif
 
 int main() {
   DDRD = 0xF0;
   DDRC = 0x00;
 
-  unsigned long moveBlockElapsedTime = 1;
-  unsigned long waitPressElapsedTime = 10;
-  unsigned long menuElapsedTime = 100;
-  const unsigned long timerPeriod = 1;
+  // The move task advances the block's fixed-point position once per period, so
+  // moveVelocity is in units of this tick; changing it rescales every level.
+  unsigned long moveBlockPeriod = TIMER_MS_TO_TICKS(5);
+  unsigned long waitPressPeriod = TIMER_MS_TO_TICKS(10);
+  unsigned long menuPeriod = TIMER_MS_TO_TICKS(100);
 
   unsigned char i = 0;
   tasks[i].state = menuIdle;
-  tasks[i].period = menuElapsedTime;
-  tasks[i].elapsedTime = tasks[i].period;
+  tasks[i].period = menuPeriod;
   tasks[i].TickFct = &tickFctMenu;
   ++i;
 
   tasks[i].state = init;
-  tasks[i].period = moveBlockElapsedTime;
-  tasks[i].elapsedTime = tasks[i].period;
+  tasks[i].period = moveBlockPeriod;
   tasks[i].TickFct = &tickFctMove;
   ++i;
 
   tasks[i].state = waitPress;
-  tasks[i].period = waitPressElapsedTime;
-  tasks[i].elapsedTime = tasks[i].period;
+  tasks[i].period = waitPressPeriod;
   tasks[i].TickFct = &tickFctCheckPress;
   ++i;
-  TimerSet(1);
+
+  tasks[i].state = panelOff;
+  tasks[i].period = 1; // set by every step, see tickFctPanel
+  tasks[i].TickFct = &tickFctPanel;
+  ++i;
   TimerOn();
+  CYCLES_INIT();
+  INPUT_INIT();
 
   SPI_INIT(); // initialize internal SPI module
-  st7735_init(); // initialize the ST7735 display
-  clearScreen();
-  
-  while(true) { 
-    for (unsigned int i = 0; i < 3; i++) {
-      if (tasks[i].elapsedTime == tasks[i].period) {
-          tasks[i].state = tasks[i].TickFct(tasks[i].state);
-          tasks[i].elapsedTime = 0;
+  // the display is brought up by tickFctPanel, except for the benchmarks
+
+#ifdef SPI_BENCHMARK
+  st7735_init();
+  SPI_BENCHMARK_RUN();
+  while (true) {
+    HAL_POLL();
+  }
+#endif
+
+#ifdef RENDER_BENCHMARK
+  st7735_init();
+  RENDER_BENCHMARK_RUN();
+  cli(); // sleeping with interrupts off ends a simavr run
+  sleep_enable();
+  sleep_cpu();
+#endif
+
+#ifdef SCHEDULER_REPORT
+  UART_INIT();
+  unsigned long nextReport = TimerNow();
+#endif
+
+  unsigned long now = TimerNow();
+  for (i = 0; i < TASKS_NUM; ++i) {
+    tasks[i].nextTime = now; // everything runs once right away
+    tasks[i].lastTime = now;
+    tasks[i].actualPeriod = 0;
+    tasks[i].maxPeriod = 0;
+    taskStatsReset(tasks[i].stats);
+  }
+
+  while(true) {
+    for (i = 0; i < TASKS_NUM; i++) {
+      now = TimerNow();
+      if ((long)(now - tasks[i].nextTime) >= 0) {
+        tasks[i].actualPeriod = now - tasks[i].lastTime;
+        if (tasks[i].actualPeriod > tasks[i].maxPeriod) {
+          tasks[i].maxPeriod = tasks[i].actualPeriod;
+        }
+        tasks[i].lastTime = now;
+        unsigned long period = tasks[i].period; // the one this tick was due by, the tick may change it
+        unsigned long start = CYCLES_NOW();
+        tasks[i].state = tasks[i].TickFct(tasks[i].state);
+        taskStatsRecord(tasks[i].stats, CYCLES_NOW() - start, tasks[i].actualPeriod, period);
+
+        tasks[i].nextTime += tasks[i].period;
+        if ((long)(TimerNow() - tasks[i].nextTime) >= 0) {
+          tasks[i].nextTime = TimerNow() + tasks[i].period; // overran, don't try to catch up
+          taskStatsMissed(tasks[i].stats);
         }
-        tasks[i].elapsedTime += timerPeriod;
       }
-      while (!TimerFlag);
-      TimerFlag = false;
+    }
+
+    // sleep until the earliest task is due, drawing what the tasks queued until then
+    unsigned long next = tasks[0].nextTime;
+    for (i = 1; i < TASKS_NUM; ++i) {
+      if ((long)(tasks[i].nextTime - next) < 0) {
+        next = tasks[i].nextTime;
+      }
+    }
+    dlRun(next);
+    st7735_endFrame();
+
+#ifdef SCHEDULER_REPORT
+    if (UART_AVAILABLE()) {
+      UART_READ();
+      schedulerReport();
+    }
+    if ((long)(TimerNow() - nextReport) >= 0) {
+      schedulerReport();
+      nextReport += TIMER_MS_TO_TICKS(2000);
+    }
+#endif
 
-      _delay_ms(5);
+    TimerSleepUntil(next);
   }
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,656 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Simulated ATmega328P for the native build (pio run -e native, see hal.h).
+//
+// Every register the game touches is an object with the avr-libc name, so the modules
+// compile unchanged. Each access costs SIM_CYCLES_PER_ACCESS simulated cycles, brings
+// the peripherals up to date and runs any interrupt that is due, which is close enough
+// to the real thing for timing-driven code (tasks, debouncing, the SPI queue) to behave
+// the same. Code that doesn't touch a register costs nothing, so cycle counts are only
+// a rough guide; use the real part or simavr for those.
+//
+// Modelled: GPIO B/C/D, SPI master (byte time from the clock divider, SPIF, interrupt),
+// Timer0 normal/CTC, Timer1 normal, Timer2 normal with compare A, pin change interrupts
+// on PORTC, USART0 TX (to stdout), idle sleep and _delay_ms(). Nothing else.
+//
+// Environment:
+//   SIM_RUN_MS=5000           stop after 5 s of simulated time (default: run forever,
+//                             or until the program sleeps with interrupts off)
+//   SIM_INPUT=1000:+1,1100:-1 hold PORTC line 1 from 1000 ms, let go at 1100 ms
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#ifndef SIM_CYCLES_PER_ACCESS
+#define SIM_CYCLES_PER_ACCESS 4 // rough cost of the code around each register access
+#endif
+#define SIM_CYCLES_PER_ISR 20 // entry and exit of an interrupt handler
+
+#define SIM_NEVER 0xFFFFFFFFFFFFFFFFULL
+
+unsigned long long simCycles = 0; // simulated time since reset, CPU cycles
+unsigned long long simSpiBytes = 0; // bytes shifted out on MOSI
+unsigned long simInterrupts = 0; // interrupt handlers run
+
+void _sim_access();
+
+struct SimReg8 {
+  unsigned char value;
+  unsigned char (*onRead)(SimReg8 &reg); // 0: plain storage
+  void (*onWrite)(SimReg8 &reg, unsigned char data);
+
+  operator unsigned char() {
+    _sim_access();
+    return onRead ? onRead(*this) : value;
+  }
+  SimReg8 &operator=(unsigned char data) {
+    _sim_access();
+    if (onWrite) {
+      onWrite(*this, data);
+    }
+    else {
+      value = data;
+    }
+    return *this;
+  }
+  SimReg8 &operator|=(int data) { unsigned char old = *this; return *this = (unsigned char)(old | data); }
+  SimReg8 &operator&=(int data) { unsigned char old = *this; return *this = (unsigned char)(old & data); }
+  SimReg8 &operator^=(int data) { unsigned char old = *this; return *this = (unsigned char)(old ^ data); }
+};
+
+struct SimReg16 {
+  unsigned int value;
+
+  operator unsigned int() {
+    _sim_access();
+    return value;
+  }
+  SimReg16 &operator=(unsigned int data) {
+    _sim_access();
+    value = data & 0xFFFF;
+    return *this;
+  }
+};
+
+typedef SimReg8 halReg8; // what PORTB and friends are, see gpio.h
+
+// Hooks for simulated devices wired to the pins
+void (*simOnPortWrite)(SimReg8 &port, unsigned char old) = 0; // after PORTB/C/D change
+void (*simOnSpiByte)(unsigned char data) = 0; // when a byte starts shifting out
+void (*simOnStop)() = 0; // before the run ends on SIM_RUN_MS
+
+unsigned char _sim_portc_in = 0; // level driven onto the PORTC pins from outside
+
+void _sim_port_write(SimReg8 &reg, unsigned char data) {
+  unsigned char old = reg.value;
+  reg.value = data;
+  if (simOnPortWrite && old != data) {
+    simOnPortWrite(reg, old);
+  }
+}
+void _sim_flag_write(SimReg8 &reg, unsigned char data) { reg.value &= ~data; } // write 1 to clear
+
+SimReg8 PORTB = {0, 0, _sim_port_write};
+SimReg8 PORTC = {0, 0, _sim_port_write};
+SimReg8 PORTD = {0, 0, _sim_port_write};
+SimReg8 DDRB = {0, 0, 0};
+SimReg8 DDRC = {0, 0, 0};
+SimReg8 DDRD = {0, 0, 0};
+
+// PINx reads outputs back and the outside level on inputs, writing 1s toggles PORTx
+unsigned char _sim_pinb_read(SimReg8 &) { return PORTB.value & DDRB.value; }
+unsigned char _sim_pinc_read(SimReg8 &) { return (PORTC.value & DDRC.value) | (_sim_portc_in & ~DDRC.value); }
+unsigned char _sim_pind_read(SimReg8 &) { return PORTD.value & DDRD.value; }
+void _sim_pinb_write(SimReg8 &, unsigned char data) { _sim_port_write(PORTB, PORTB.value ^ data); }
+void _sim_pinc_write(SimReg8 &, unsigned char data) { _sim_port_write(PORTC, PORTC.value ^ data); }
+void _sim_pind_write(SimReg8 &, unsigned char data) { _sim_port_write(PORTD, PORTD.value ^ data); }
+
+SimReg8 PINB = {0, _sim_pinb_read, _sim_pinb_write};
+SimReg8 PINC = {0, _sim_pinc_read, _sim_pinc_write};
+SimReg8 PIND = {0, _sim_pind_read, _sim_pind_write};
+
+SimReg8 SREG = {0, 0, 0};
+
+// SPI
+bool _sim_spi_active = false;
+unsigned long long _sim_spi_done = 0; // when the byte in flight is out
+
+SimReg8 SPCR = {0, 0, 0};
+
+unsigned char _sim_spdr_read(SimReg8 &);
+void _sim_spdr_write(SimReg8 &, unsigned char data);
+void _sim_spsr_write(SimReg8 &reg, unsigned char data) { reg.value = (reg.value & 0xFE) | (data & 0x01); }
+
+SimReg8 SPSR = {0, 0, _sim_spsr_write};
+SimReg8 SPDR = {0, _sim_spdr_read, _sim_spdr_write};
+
+// Timers
+SimReg8 TCCR0A = {0, 0, 0};
+SimReg8 TCCR0B = {0, 0, 0};
+SimReg8 TCNT0 = {0, 0, 0};
+SimReg8 OCR0A = {0, 0, 0};
+SimReg8 TIMSK0 = {0, 0, 0};
+SimReg8 TIFR0 = {0, 0, _sim_flag_write};
+
+SimReg8 TCCR1A = {0, 0, 0};
+SimReg8 TCCR1B = {0, 0, 0};
+SimReg16 TCNT1 = {0};
+SimReg8 TIMSK1 = {0, 0, 0};
+SimReg8 TIFR1 = {0, 0, _sim_flag_write};
+
+SimReg8 TCCR2A = {0, 0, 0};
+SimReg8 TCCR2B = {0, 0, 0};
+SimReg8 TCNT2 = {0, 0, 0};
+SimReg8 OCR2A = {0, 0, 0};
+SimReg8 TIMSK2 = {0, 0, 0};
+SimReg8 TIFR2 = {0, 0, _sim_flag_write};
+
+// Pin change
+SimReg8 PCICR = {0, 0, 0};
+SimReg8 PCMSK0 = {0, 0, 0};
+SimReg8 PCMSK1 = {0, 0, 0};
+SimReg8 PCMSK2 = {0, 0, 0};
+SimReg8 PCIFR = {0, 0, _sim_flag_write};
+
+// USART0, transmit only
+unsigned char _sim_ucsr0a_read(SimReg8 &reg) { return reg.value | (1 << 5) | (1 << 6); } // UDRE0, TXC0
+void _sim_udr0_write(SimReg8 &, unsigned char data) {
+  putchar(data);
+  if (data == '\n') {
+    fflush(stdout);
+  }
+}
+
+SimReg8 UCSR0A = {0, _sim_ucsr0a_read, 0};
+SimReg8 UCSR0B = {0, 0, 0};
+SimReg8 UCSR0C = {0, 0, 0};
+SimReg16 UBRR0 = {0};
+SimReg8 UDR0 = {0, 0, _sim_udr0_write};
+
+// Bits
+#define _BV(bit) (1 << (bit))
+
+#define PORTB0 0
+#define PORTB1 1
+#define PORTB2 2
+#define PORTB3 3
+#define PORTB4 4
+#define PORTB5 5
+#define PORTB6 6
+#define PORTB7 7
+#define PORTC0 0
+#define PORTC1 1
+#define PORTC2 2
+#define PORTC3 3
+#define PORTC4 4
+#define PORTC5 5
+#define PORTC6 6
+#define PORTD0 0
+#define PORTD1 1
+#define PORTD2 2
+#define PORTD3 3
+#define PORTD4 4
+#define PORTD5 5
+#define PORTD6 6
+#define PORTD7 7
+
+#define SPIE 7
+#define SPE 6
+#define DORD 5
+#define MSTR 4
+#define CPOL 3
+#define CPHA 2
+#define SPR1 1
+#define SPR0 0
+#define SPIF 7
+#define WCOL 6
+#define SPI2X 0
+
+#define WGM01 1
+#define WGM00 0
+#define CS02 2
+#define CS01 1
+#define CS00 0
+#define OCIE0A 1
+#define TOIE0 0
+#define OCF0A 1
+#define TOV0 0
+
+#define CS12 2
+#define CS11 1
+#define CS10 0
+#define TOIE1 0
+#define TOV1 0
+
+#define CS22 2
+#define CS21 1
+#define CS20 0
+#define OCIE2A 1
+#define TOIE2 0
+#define OCF2A 1
+#define TOV2 0
+
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PCIF0 0
+#define PCIF1 1
+#define PCIF2 2
+
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define U2X0 1
+#define RXEN0 4
+#define TXEN0 3
+#define UCSZ01 2
+#define UCSZ00 1
+
+// Interrupts. Handlers the program doesn't define stay null and never run.
+#define ISR(vector) extern "C" void vector(void)
+
+#define PCINT1_vect _sim_vector_pcint1
+#define TIMER2_COMPA_vect _sim_vector_timer2_compa
+#define TIMER2_OVF_vect _sim_vector_timer2_ovf
+#define TIMER1_OVF_vect _sim_vector_timer1_ovf
+#define TIMER0_COMPA_vect _sim_vector_timer0_compa
+#define SPI_STC_vect _sim_vector_spi_stc
+
+extern "C" void PCINT1_vect(void) __attribute__((weak));
+extern "C" void TIMER2_COMPA_vect(void) __attribute__((weak));
+extern "C" void TIMER2_OVF_vect(void) __attribute__((weak));
+extern "C" void TIMER1_OVF_vect(void) __attribute__((weak));
+extern "C" void TIMER0_COMPA_vect(void) __attribute__((weak));
+extern "C" void SPI_STC_vect(void) __attribute__((weak));
+
+inline void cli() { SREG.value &= ~0x80; }
+inline void sei() { SREG.value |= 0x80; } // like the chip, nothing runs before the next access
+
+// Program memory is just memory here
+#define PROGMEM
+#define pgm_read_byte(addr) (*(addr))
+#define pgm_read_word(addr) (*(addr))
+
+// Peripherals
+
+unsigned long long _sim_synced = 0; // simCycles the peripherals were last brought up to
+
+// Timer clock select to prescaler, 0 for stopped (or an external clock, not modelled)
+unsigned int _sim_prescale(unsigned char cs, bool timer2) {
+  static const unsigned int prescale[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+  static const unsigned int prescale2[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+  return timer2 ? prescale2[cs & 0x07] : prescale[cs & 0x07];
+}
+
+// A counter as far as the simulator cares: counts to top - 1 and wraps, optionally
+// flagging when it reaches compare on the way (-1 for no compare unit in use)
+struct _simCounter {
+  unsigned int prescale;
+  unsigned long top;
+  long compare;
+};
+
+// Timer ticks until the counter next wraps or matches
+unsigned long _sim_ticks_to_event(const _simCounter &c, unsigned long count) {
+  unsigned long ticks = c.top - count;
+  if (c.compare >= 0) {
+    unsigned long match = (unsigned long)c.compare;
+    unsigned long toMatch = (match > count) ? match - count : match + c.top - count;
+    if (toMatch < ticks) {
+      ticks = toMatch;
+    }
+  }
+  return ticks;
+}
+
+// Advance count by ticks (at most up to the next event), returns 1 for a wrap, 2 for
+// a compare match, or both
+unsigned char _sim_count(const _simCounter &c, unsigned long &count, unsigned long ticks) {
+  unsigned char events = 0;
+  unsigned long next = count + ticks;
+  if (c.compare >= 0) {
+    unsigned long match = (unsigned long)c.compare;
+    if ((count < match && match <= next) || (next >= c.top && match <= next - c.top)) {
+      events |= 2;
+    }
+  }
+  if (next >= c.top) {
+    next -= c.top;
+    events |= 1;
+  }
+  count = next;
+  return events;
+}
+
+_simCounter _sim_timer0() {
+  _simCounter c;
+  c.prescale = _sim_prescale(TCCR0B.value, false);
+  if (TCCR0A.value & (1 << WGM01)) {
+    c.top = (unsigned long)OCR0A.value + 1; // CTC, the match is the wrap
+    c.compare = -1;
+  }
+  else {
+    c.top = 256;
+    c.compare = OCR0A.value;
+  }
+  return c;
+}
+
+_simCounter _sim_timer1() {
+  _simCounter c;
+  c.prescale = _sim_prescale(TCCR1B.value, false);
+  c.top = 65536;
+  c.compare = -1;
+  return c;
+}
+
+_simCounter _sim_timer2() {
+  _simCounter c;
+  c.prescale = _sim_prescale(TCCR2B.value, true);
+  c.top = 256;
+  c.compare = OCR2A.value;
+  return c;
+}
+
+// Cycle at which a counter that is ticks away from its next event gets there. The
+// prescaler is shared and free running, so ticks fall on multiples of it.
+unsigned long long _sim_tick_cycle(unsigned int prescale, unsigned long ticks) {
+  return ((simCycles / prescale) + ticks) * prescale;
+}
+
+// Scripted input
+#define SIM_INPUT_MAX 64
+
+struct _simInputChange {
+  unsigned long long at; // simCycles
+  unsigned char line;    // PORTC bit
+  bool held;
+};
+
+_simInputChange _sim_inputs[SIM_INPUT_MAX];
+unsigned char _sim_input_count = 0;
+unsigned char _sim_input_next = 0;
+unsigned long long _sim_stop_at = SIM_NEVER;
+
+// Drive a PORTC line from outside right now, buttons read 1 while held
+void simSetInput(unsigned char line, bool held) {
+  unsigned char old = _sim_portc_in;
+  _sim_portc_in = held ? (old | (1 << line)) : (old & ~(1 << line));
+  if ((old ^ _sim_portc_in) & ~DDRC.value & PCMSK1.value) {
+    PCIFR.value |= (1 << PCIF1);
+  }
+}
+
+// Hold or release a line at ms of simulated time. Changes can be added in any order.
+void simScheduleInput(unsigned long ms, unsigned char line, bool held) {
+  if (_sim_input_count == SIM_INPUT_MAX) {
+    fprintf(stderr, "sim: too many input changes\n");
+    exit(2);
+  }
+  unsigned long long at = (unsigned long long)ms * (F_CPU / 1000);
+  unsigned char n = _sim_input_count++;
+  while (n > _sim_input_next && _sim_inputs[n - 1].at > at) {
+    _sim_inputs[n] = _sim_inputs[n - 1];
+    --n;
+  }
+  _sim_inputs[n].at = at;
+  _sim_inputs[n].line = line;
+  _sim_inputs[n].held = held;
+}
+
+// Stop (exit(0)) once ms of simulated time have passed
+void simStopAt(unsigned long ms) {
+  _sim_stop_at = (unsigned long long)ms * (F_CPU / 1000);
+}
+
+unsigned long simNowMs() {
+  return simCycles / (F_CPU / 1000);
+}
+
+void _sim_stop() {
+  if (simOnStop) {
+    simOnStop();
+  }
+  fprintf(stderr, "sim: stopped at %lu ms, %llu cycles, %llu spi bytes, %lu interrupts\n",
+          simNowMs(), simCycles, simSpiBytes, simInterrupts);
+  exit(0);
+}
+
+// Bring everything up to simCycles
+void _sim_sync() {
+  unsigned long long from = _sim_synced;
+  _sim_synced = simCycles;
+
+  _simCounter c = _sim_timer0();
+  if (c.prescale) {
+    unsigned long count = TCNT0.value;
+    unsigned char events = _sim_count(c, count, simCycles / c.prescale - from / c.prescale);
+    TCNT0.value = count;
+    if (events & 1) {
+      TIFR0.value |= (TCCR0A.value & (1 << WGM01)) ? (1 << OCF0A) : (1 << TOV0);
+    }
+    if (events & 2) {
+      TIFR0.value |= (1 << OCF0A);
+    }
+  }
+
+  c = _sim_timer1();
+  if (c.prescale) {
+    unsigned long count = TCNT1.value;
+    if (_sim_count(c, count, simCycles / c.prescale - from / c.prescale) & 1) {
+      TIFR1.value |= (1 << TOV1);
+    }
+    TCNT1.value = count;
+  }
+
+  c = _sim_timer2();
+  if (c.prescale) {
+    unsigned long count = TCNT2.value;
+    unsigned char events = _sim_count(c, count, simCycles / c.prescale - from / c.prescale);
+    TCNT2.value = count;
+    if (events & 1) {
+      TIFR2.value |= (1 << TOV2);
+    }
+    if (events & 2) {
+      TIFR2.value |= (1 << OCF2A);
+    }
+  }
+
+  if (_sim_spi_active && simCycles >= _sim_spi_done) {
+    _sim_spi_active = false;
+    SPSR.value |= (1 << SPIF);
+  }
+
+  while (_sim_input_next < _sim_input_count && _sim_inputs[_sim_input_next].at <= simCycles) {
+    simSetInput(_sim_inputs[_sim_input_next].line, _sim_inputs[_sim_input_next].held);
+    ++_sim_input_next;
+  }
+
+  if (simCycles >= _sim_stop_at) {
+    _sim_stop();
+  }
+}
+
+// Earliest cycle anything happens on its own
+unsigned long long _sim_next_event() {
+  unsigned long long next = _sim_stop_at;
+  _simCounter timers[3] = {_sim_timer0(), _sim_timer1(), _sim_timer2()};
+  unsigned long counts[3] = {TCNT0.value, TCNT1.value, TCNT2.value};
+  for (unsigned char n = 0; n < 3; ++n) {
+    if (timers[n].prescale) {
+      unsigned long long at = _sim_tick_cycle(timers[n].prescale, _sim_ticks_to_event(timers[n], counts[n]));
+      if (at < next) {
+        next = at;
+      }
+    }
+  }
+  if (_sim_spi_active && _sim_spi_done < next) {
+    next = _sim_spi_done;
+  }
+  if (_sim_input_next < _sim_input_count && _sim_inputs[_sim_input_next].at < next) {
+    next = _sim_inputs[_sim_input_next].at;
+  }
+  return next;
+}
+
+bool _sim_in_isr = false;
+
+void _sim_run_isr(void (*handler)(void)) {
+  SREG.value &= ~0x80;
+  _sim_in_isr = true;
+  simCycles += SIM_CYCLES_PER_ISR;
+  ++simInterrupts;
+  handler();
+  _sim_in_isr = false;
+  SREG.value |= 0x80;
+}
+
+// Run every interrupt that is pending and enabled, in vector order. Returns whether
+// any ran.
+bool _sim_dispatch() {
+  bool ran = false;
+  while (!_sim_in_isr && (SREG.value & 0x80)) {
+    if ((PCIFR.value & (1 << PCIF1)) && (PCICR.value & (1 << PCIE1)) && PCINT1_vect) {
+      PCIFR.value &= ~(1 << PCIF1);
+      _sim_run_isr(PCINT1_vect);
+    }
+    else if ((TIFR2.value & (1 << OCF2A)) && (TIMSK2.value & (1 << OCIE2A)) && TIMER2_COMPA_vect) {
+      TIFR2.value &= ~(1 << OCF2A);
+      _sim_run_isr(TIMER2_COMPA_vect);
+    }
+    else if ((TIFR2.value & (1 << TOV2)) && (TIMSK2.value & (1 << TOIE2)) && TIMER2_OVF_vect) {
+      TIFR2.value &= ~(1 << TOV2);
+      _sim_run_isr(TIMER2_OVF_vect);
+    }
+    else if ((TIFR1.value & (1 << TOV1)) && (TIMSK1.value & (1 << TOIE1)) && TIMER1_OVF_vect) {
+      TIFR1.value &= ~(1 << TOV1);
+      _sim_run_isr(TIMER1_OVF_vect);
+    }
+    else if ((TIFR0.value & (1 << OCF0A)) && (TIMSK0.value & (1 << OCIE0A)) && TIMER0_COMPA_vect) {
+      TIFR0.value &= ~(1 << OCF0A);
+      _sim_run_isr(TIMER0_COMPA_vect);
+    }
+    else if ((SPSR.value & (1 << SPIF)) && (SPCR.value & (1 << SPIE)) && (SPCR.value & (1 << SPE))
+             && SPI_STC_vect) {
+      SPSR.value &= ~(1 << SPIF);
+      _sim_run_isr(SPI_STC_vect);
+    }
+    else {
+      break;
+    }
+    ran = true;
+    _sim_sync();
+  }
+  return ran;
+}
+
+// Let simulated time pass up to target, events and interrupts included
+void _sim_advance(unsigned long long target) {
+  while (simCycles < target) {
+    unsigned long long next = _sim_next_event();
+    simCycles = (next < target) ? next : target;
+    _sim_sync();
+    _sim_dispatch();
+  }
+}
+
+void _sim_access() {
+  simCycles += SIM_CYCLES_PER_ACCESS;
+  _sim_sync();
+  _sim_dispatch();
+}
+
+unsigned char _sim_spdr_read(SimReg8 &) {
+  SPSR.value &= ~(1 << SPIF);
+  return 0; // nothing on MISO
+}
+
+void _sim_spdr_write(SimReg8 &reg, unsigned char data) {
+  SPSR.value &= ~(1 << SPIF);
+  if (!(SPCR.value & (1 << SPE))) {
+    return;
+  }
+  if (_sim_spi_active) {
+    SPSR.value |= (1 << WCOL);
+    return;
+  }
+  static const unsigned char divider[4] = {4, 16, 64, 128};
+  unsigned int cycles = 8 * divider[SPCR.value & 0x03];
+  if (SPSR.value & (1 << SPI2X)) {
+    cycles /= 2;
+  }
+  reg.value = data;
+  _sim_spi_active = true;
+  _sim_spi_done = simCycles + cycles;
+  ++simSpiBytes;
+  if (simOnSpiByte) {
+    simOnSpiByte(data);
+  }
+}
+
+// Sleep and delays
+
+#define SLEEP_MODE_IDLE 0
+#define set_sleep_mode(mode)
+#define sleep_enable()
+#define sleep_disable()
+
+// Idle sleep: skip ahead to the next event until an interrupt has run
+void sleep_cpu() {
+  while (!_sim_dispatch()) {
+    if (!(SREG.value & 0x80)) {
+      _sim_stop(); // nothing can wake it, simavr ends the run here too
+    }
+    unsigned long long next = _sim_next_event();
+    if (next == SIM_NEVER) {
+      fprintf(stderr, "sim: sleeping with nothing left to wake up\n");
+      exit(1);
+    }
+    simCycles = next;
+    _sim_sync();
+  }
+}
+
+inline void _delay_ms(double ms) {
+  _sim_advance(simCycles + (unsigned long long)(ms * (F_CPU / 1000)));
+}
+
+inline void _delay_us(double us) {
+  _sim_advance(simCycles + (unsigned long long)(us * (F_CPU / 1000000)));
+}
+
+// Busy-wait loops on flags set by interrupts call this, see HAL_POLL() in hal.h
+#define HAL_POLL() _sim_access()
+
+// Reads SIM_RUN_MS and SIM_INPUT before main() runs
+struct _simStartup {
+  _simStartup() {
+    const char *run = getenv("SIM_RUN_MS");
+    if (run) {
+      simStopAt(strtoul(run, 0, 10));
+    }
+    const char *input = getenv("SIM_INPUT");
+    while (input && *input) {
+      char *end;
+      unsigned long ms = strtoul(input, &end, 10);
+      if (*end != ':' || (end[1] != '+' && end[1] != '-')) {
+        fprintf(stderr, "sim: SIM_INPUT wants ms:+line or ms:-line, comma separated\n");
+        exit(2);
+      }
+      bool held = (end[1] == '+');
+      unsigned char line = strtoul(end + 2, &end, 10);
+      simScheduleInput(ms, line, held);
+      input = (*end == ',') ? end + 1 : end;
+    }
+  }
+};
+
+_simStartup _sim_startup;
+
+#endif // SIM_H
@@ -0,0 +1,376 @@
+#ifndef ST7735_SIM_H
+#define ST7735_SIM_H
+
+// Simulated ST7735 panel for the native build, wired like the real one: CS on PORTB2,
+// A0 on PORTD7, RESET on PORTD6, bytes taken off MOSI as the SPI starts shifting them.
+//
+// It decodes the command stream the way the controller does (SWRESET, SLPOUT, COLMOD,
+// CASET, RASET, RAMWR, VSCRDEF, VSCRSADD, DISPON...) into 128 columns of the 162 line
+// frame memory, RGB565, and counts what it cost. The screen is the first 128 lines of
+// the display as vertical scrolling maps them (SIM_PANEL_HEIGHT). A frame is one pass of the main loop, closed by st7735_endFrame() through
+// HAL_FRAME_END() (see hal.h); frames that put nothing on the wire are not counted.
+//
+// Environment:
+//   SIM_FRAMES=out/frame    write out/frame00012.ppm for every frame that changed pixels
+//   SIM_PANEL_LOG=1         one line of counters on stderr per frame
+//
+// Pixels are 16 bit (COLMOD 0x05), 12 bit (0x03, 3 bytes per 2 pixels) or 18 bit
+// (0x06, 3 bytes per pixel), all kept as RGB565. Reads, rotation (MADCTL) and the
+// gamma tables are not modelled; commands for them are counted as unknown.
+
+#include "sim.h"
+
+#define SIM_PANEL_WIDTH 128
+#define SIM_PANEL_HEIGHT 128
+#define SIM_PANEL_LINES 162 // of frame memory
+
+#define SIM_PANEL_CS PORTB2
+#define SIM_PANEL_A0 PORTD7
+#define SIM_PANEL_RESET PORTD6
+
+struct simPanelStats {
+  unsigned long bytes;     // clocked in with CS low, commands and data
+  unsigned long commands;  // bytes with A0 low
+  unsigned long unknown;   // commands the model ignores
+  unsigned long csToggles; // CS falling edges
+  unsigned long csBreaks;  // CS released between a window's CASET/RASET and its last pixel
+  unsigned long pixels;    // pixels written into the window
+  unsigned long redundant; // pixels overwritten with the value they already had
+  unsigned long clipped;   // pixels that landed outside the 128 columns x 162 lines
+};
+
+unsigned int simPanel[SIM_PANEL_LINES][SIM_PANEL_WIDTH]; // frame memory, RGB565, [line][column]
+
+simPanelStats simPanelFrame;     // counting since the last frame ended
+simPanelStats simPanelLastFrame; // the previous frame with any traffic
+simPanelStats simPanelTotal;     // since power up
+unsigned long simPanelFrames = 0; // frames with any traffic
+
+void (*simOnFrame)() = 0; // after every frame, drawn on or not
+
+bool simPanelAwake = false;     // SLPOUT seen since the last reset
+bool simPanelDisplayOn = false; // DISPON seen since the last reset
+unsigned long simPanelOnMs = 0;  // when the display last went on
+
+// Controller state
+unsigned char _sim_panel_cmd = 0x00; // command the data bytes belong to
+unsigned char _sim_panel_arg = 0;    // data bytes since that command
+unsigned char _sim_panel_args[6];
+unsigned char _sim_panel_colmod = 0x06; // 18 bit after reset
+int _sim_panel_colStart, _sim_panel_colEnd, _sim_panel_rowStart, _sim_panel_rowEnd;
+int _sim_panel_col, _sim_panel_row; // where the next pixel goes
+int _sim_panel_scrollTop, _sim_panel_scrollHeight, _sim_panel_scrollStart; // VSCRDEF, VSCRSADD
+unsigned char _sim_panel_pixel[3];  // bytes of a pixel (or 12 bit pair) still coming in
+unsigned char _sim_panel_pixelBytes = 0;
+bool _sim_panel_changed = false; // a pixel changed value this frame
+bool _sim_panel_windowOpen = false;   // CASET/RASET/RAMWR seen, window not written in full yet
+unsigned long _sim_panel_windowLeft = 0; // pixels the window still takes after RAMWR
+
+const char *_sim_panel_frames = 0; // SIM_FRAMES
+bool _sim_panel_log = false;       // SIM_PANEL_LOG
+
+void _sim_panel_reset() {
+  _sim_panel_cmd = 0x00;
+  _sim_panel_arg = 0;
+  _sim_panel_colmod = 0x06;
+  _sim_panel_colStart = 0;
+  _sim_panel_colEnd = 131;
+  _sim_panel_rowStart = 0;
+  _sim_panel_rowEnd = 161;
+  _sim_panel_col = 0;
+  _sim_panel_row = 0;
+  _sim_panel_pixelBytes = 0;
+  _sim_panel_windowOpen = false;
+  _sim_panel_scrollTop = 0;
+  _sim_panel_scrollHeight = SIM_PANEL_LINES;
+  _sim_panel_scrollStart = 0;
+  simPanelAwake = false;
+  simPanelDisplayOn = false;
+}
+
+void _sim_panel_put(unsigned int color) {
+  ++simPanelFrame.pixels;
+  if (_sim_panel_windowLeft && --_sim_panel_windowLeft == 0) {
+    _sim_panel_windowOpen = false;
+  }
+  if (_sim_panel_col < SIM_PANEL_WIDTH && _sim_panel_row < SIM_PANEL_LINES) {
+    unsigned int &pixel = simPanel[_sim_panel_row][_sim_panel_col];
+    if (pixel == color) {
+      ++simPanelFrame.redundant;
+    }
+    else {
+      pixel = color;
+      _sim_panel_changed = true;
+    }
+  }
+  else {
+    ++simPanelFrame.clipped;
+  }
+  // left to right, top to bottom, back to the top left after the last one
+  if (++_sim_panel_col > _sim_panel_colEnd) {
+    _sim_panel_col = _sim_panel_colStart;
+    if (++_sim_panel_row > _sim_panel_rowEnd) {
+      _sim_panel_row = _sim_panel_rowStart;
+    }
+  }
+}
+
+// 4 and 6 bit channels to RGB565
+unsigned int _sim_panel_rgb(unsigned char r, unsigned char g, unsigned char b, unsigned char bits) {
+  if (bits == 4) {
+    return ((r << 1 | r >> 3) << 11) | ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3);
+  }
+  return ((r >> 1) << 11) | (g << 5) | (b >> 1);
+}
+
+void _sim_panel_ramwr(unsigned char data) {
+  _sim_panel_pixel[_sim_panel_pixelBytes++] = data;
+  unsigned char *p = _sim_panel_pixel;
+  if (_sim_panel_colmod == 0x05 && _sim_panel_pixelBytes == 2) {
+    _sim_panel_put((p[0] << 8) | p[1]);
+  }
+  else if (_sim_panel_colmod == 0x03 && _sim_panel_pixelBytes == 2) {
+    // RRRRGGGG BBBBrrrr ggggbbbb, the first pixel is complete after 12 bits
+    _sim_panel_put(_sim_panel_rgb(p[0] >> 4, p[0] & 0x0F, p[1] >> 4, 4));
+    return;
+  }
+  else if (_sim_panel_colmod == 0x03 && _sim_panel_pixelBytes == 3) {
+    _sim_panel_put(_sim_panel_rgb(p[1] & 0x0F, p[2] >> 4, p[2] & 0x0F, 4));
+  }
+  else if (_sim_panel_colmod != 0x05 && _sim_panel_colmod != 0x03 && _sim_panel_pixelBytes == 3) {
+    _sim_panel_put(_sim_panel_rgb(p[0] >> 2, p[1] >> 2, p[2] >> 2, 6));
+  }
+  else {
+    return;
+  }
+  _sim_panel_pixelBytes = 0;
+}
+
+void _sim_panel_command(unsigned char cmd) {
+  ++simPanelFrame.commands;
+  _sim_panel_cmd = cmd;
+  _sim_panel_arg = 0;
+  _sim_panel_pixelBytes = 0;
+  _sim_panel_windowOpen = (cmd == 0x2A || cmd == 0x2B || cmd == 0x2C);
+  _sim_panel_windowLeft = 0;
+  switch (cmd) {
+    case 0x00: // NOP
+      break;
+    case 0x01: // SWRESET
+      _sim_panel_reset();
+      break;
+    case 0x10: // SLPIN
+      simPanelAwake = false;
+      break;
+    case 0x11: // SLPOUT
+      simPanelAwake = true;
+      break;
+    case 0x28: // DISPOFF
+      simPanelDisplayOn = false;
+      break;
+    case 0x29: // DISPON
+      if (!simPanelDisplayOn) {
+        simPanelOnMs = simNowMs();
+      }
+      simPanelDisplayOn = true;
+      break;
+    case 0x2C: // RAMWR
+      _sim_panel_col = _sim_panel_colStart;
+      _sim_panel_row = _sim_panel_rowStart;
+      _sim_panel_windowLeft = (unsigned long)(_sim_panel_colEnd - _sim_panel_colStart + 1)
+                              * (_sim_panel_rowEnd - _sim_panel_rowStart + 1);
+      break;
+    case 0x2A: // CASET
+    case 0x2B: // RASET
+    case 0x33: // VSCRDEF
+    case 0x37: // VSCRSADD
+    case 0x3A: // COLMOD
+      break;
+    default:
+      ++simPanelFrame.unknown;
+      break;
+  }
+}
+
+void _sim_panel_data(unsigned char data) {
+  switch (_sim_panel_cmd) {
+    case 0x2A: // CASET
+    case 0x2B: // RASET
+      if (_sim_panel_arg < 4) {
+        _sim_panel_args[_sim_panel_arg] = data;
+      }
+      if (++_sim_panel_arg == 4) {
+        int start = (_sim_panel_args[0] << 8) | _sim_panel_args[1];
+        int end = (_sim_panel_args[2] << 8) | _sim_panel_args[3];
+        if (_sim_panel_cmd == 0x2A) {
+          _sim_panel_colStart = start;
+          _sim_panel_colEnd = end;
+        }
+        else {
+          _sim_panel_rowStart = start;
+          _sim_panel_rowEnd = end;
+        }
+      }
+      break;
+    case 0x33: // VSCRDEF, top fixed, scroll and bottom fixed lines; the bottom follows
+      if (_sim_panel_arg < 6) {
+        _sim_panel_args[_sim_panel_arg] = data;
+      }
+      if (++_sim_panel_arg == 4) {
+        _sim_panel_scrollTop = (_sim_panel_args[0] << 8) | _sim_panel_args[1];
+        _sim_panel_scrollHeight = (_sim_panel_args[2] << 8) | _sim_panel_args[3];
+      }
+      break;
+    case 0x37: // VSCRSADD
+      if (_sim_panel_arg < 2) {
+        _sim_panel_args[_sim_panel_arg] = data;
+      }
+      if (++_sim_panel_arg == 2) {
+        _sim_panel_scrollStart = (_sim_panel_args[0] << 8) | _sim_panel_args[1];
+      }
+      break;
+    case 0x3A: // COLMOD
+      if (_sim_panel_arg++ == 0) {
+        _sim_panel_colmod = data & 0x07;
+      }
+      break;
+    case 0x2C: // RAMWR
+      _sim_panel_ramwr(data);
+      break;
+    default:
+      break;
+  }
+}
+
+void _sim_panel_byte(unsigned char data) {
+  if (PORTB.value & (1 << SIM_PANEL_CS)) {
+    return; // not selected
+  }
+  ++simPanelFrame.bytes;
+  if (PORTD.value & (1 << SIM_PANEL_A0)) {
+    _sim_panel_data(data);
+  }
+  else {
+    _sim_panel_command(data);
+  }
+}
+
+void _sim_panel_pins(SimReg8 &port, unsigned char old) {
+  unsigned char fell = old & ~port.value;
+  unsigned char rose = ~old & port.value;
+  if (&port == &PORTB && (fell & (1 << SIM_PANEL_CS))) {
+    ++simPanelFrame.csToggles;
+  }
+  if (&port == &PORTB && (rose & (1 << SIM_PANEL_CS)) && _sim_panel_windowOpen) {
+    ++simPanelFrame.csBreaks;
+  }
+  if (&port == &PORTD && (fell & (1 << SIM_PANEL_RESET))) {
+    _sim_panel_reset();
+  }
+}
+
+void _sim_panel_add(simPanelStats &to, const simPanelStats &from) {
+  to.bytes += from.bytes;
+  to.commands += from.commands;
+  to.unknown += from.unknown;
+  to.csToggles += from.csToggles;
+  to.csBreaks += from.csBreaks;
+  to.pixels += from.pixels;
+  to.redundant += from.redundant;
+  to.clipped += from.clipped;
+}
+
+void _sim_panel_print(const char *what, const simPanelStats &s) {
+  fprintf(stderr, "%s bytes=%lu commands=%lu unknown=%lu cs=%lu cs_breaks=%lu pixels=%lu redundant=%lu clipped=%lu\n",
+          what, s.bytes, s.commands, s.unknown, s.csToggles, s.csBreaks, s.pixels, s.redundant, s.clipped);
+}
+
+// Frame memory line shown on screen row `row`, through the scroll area
+int simPanelLine(int row) {
+  int top = _sim_panel_scrollTop, height = _sim_panel_scrollHeight;
+  if (row < top || row >= top + height || height <= 0) {
+    return row;
+  }
+  int offset = (row - top + _sim_panel_scrollStart - top) % height;
+  int line = top + (offset < 0 ? offset + height : offset);
+  return (line >= 0 && line < SIM_PANEL_LINES) ? line : row;
+}
+
+// Screen pixel as 8 bit R, G, B, the way the PPM files have it
+void simPanelRgb888(int col, int row, unsigned char rgb[3]) {
+  unsigned int c = simPanel[simPanelLine(row)][col];
+  unsigned char r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+  rgb[0] = r << 3 | r >> 2;
+  rgb[1] = g << 2 | g >> 4;
+  rgb[2] = b << 3 | b >> 2;
+}
+
+// Write the screen as a binary PPM, returns false if the file can't be written
+bool simPanelWritePpm(const char *path) {
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  fprintf(file, "P6\n%d %d\n255\n", SIM_PANEL_WIDTH, SIM_PANEL_HEIGHT);
+  for (int row = 0; row < SIM_PANEL_HEIGHT; ++row) {
+    for (int col = 0; col < SIM_PANEL_WIDTH; ++col) {
+      unsigned char rgb[3];
+      simPanelRgb888(col, row, rgb);
+      fwrite(rgb, 1, 3, file);
+    }
+  }
+  return fclose(file) == 0;
+}
+
+// Close the current frame, see HAL_FRAME_END() in hal.h
+void simPanelEndFrame() {
+  if (simPanelFrame.bytes == 0 && simPanelFrame.csToggles == 0) {
+    if (simOnFrame) {
+      simOnFrame();
+    }
+    return; // nothing on the wire, not counted
+  }
+  ++simPanelFrames;
+  if (_sim_panel_log) {
+    char what[48];
+    snprintf(what, sizeof(what), "panel frame=%lu ms=%lu", simPanelFrames, simNowMs());
+    _sim_panel_print(what, simPanelFrame);
+  }
+  if (_sim_panel_frames && _sim_panel_changed) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s%05lu.ppm", _sim_panel_frames, simPanelFrames);
+    if (!simPanelWritePpm(path)) {
+      fprintf(stderr, "sim: can't write %s\n", path);
+      exit(2);
+    }
+  }
+  _sim_panel_add(simPanelTotal, simPanelFrame);
+  simPanelLastFrame = simPanelFrame;
+  memset(&simPanelFrame, 0, sizeof(simPanelFrame));
+  _sim_panel_changed = false;
+  if (simOnFrame) {
+    simOnFrame();
+  }
+}
+
+void _sim_panel_stop() {
+  simPanelEndFrame();
+  char what[48];
+  snprintf(what, sizeof(what), "panel on_ms=%lu frames=%lu", simPanelOnMs, simPanelFrames);
+  _sim_panel_print(what, simPanelTotal);
+}
+
+struct _simPanelStartup {
+  _simPanelStartup() {
+    _sim_panel_reset();
+    simOnSpiByte = _sim_panel_byte;
+    simOnPortWrite = _sim_panel_pins;
+    simOnStop = _sim_panel_stop;
+    _sim_panel_frames = getenv("SIM_FRAMES");
+    _sim_panel_log = getenv("SIM_PANEL_LOG") != 0;
+  }
+};
+
+_simPanelStartup _sim_panel_startup;
+
+#endif // ST7735_SIM_H
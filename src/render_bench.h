@@ -0,0 +1,143 @@
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+
+#include "cycles.h"
+#include "spi.h"
+#include "st7735.h"
+#include "uart.h"
+
+// Rendering benchmark, built with -DRENDER_BENCHMARK. pio run -e render_bench -t upload
+// runs it in simavr (no board needed), pio run -e native_render_bench on the host
+// simulator. Every drawing primitive and every game screen is run once from a white
+// panel and reported on one line:
+//
+//   op=clear cycles=... us=... spi_bytes=... stack=... pixels_saved=...
+//
+// cycles comes from Timer1 with the cost of an empty measurement taken off, spi_bytes
+// counts everything handed to the SPI (SPI_COUNT_BYTES, main.cpp turns it on), and stack is the
+// deepest the stack went below the caller's frame, found by painting the free RAM
+// before the call. Draws the game queues on the display list are drawn, and waiting
+// fills sent, inside the measurement (dlFinish()); pixels_saved is what the dirty
+// rectangles kept off the wire (st7735_fillRect()). The host simulator has no AVR stack and reports stack=0.
+// The last line is "done", after which the CPU sleeps with interrupts off, which is
+// where simavr stops.
+//
+// Needs the draw functions from main.cpp, so it is included just before main().
+
+struct renderBenchOp {
+  const char *name;
+  void (*setup)(); // after the clear, not timed; 0 for none
+  void (*run)();
+};
+
+#ifndef NATIVE
+extern unsigned char __heap_start; // end of .data/.bss, nothing uses malloc
+
+#define RENDER_BENCH_PAINT 0xA5
+#define RENDER_BENCH_MARGIN 32 // left alone under the painting function's own frame
+
+unsigned char *_renderBenchBase; // SP at the call, stack use is counted from here
+
+void _renderBenchPaint() {
+  _renderBenchBase = (unsigned char *)SP;
+  unsigned char *p = &__heap_start;
+  while (p < _renderBenchBase - RENDER_BENCH_MARGIN) {
+    *p++ = RENDER_BENCH_PAINT;
+  }
+}
+
+// Bytes of stack used below _renderBenchBase since the paint
+unsigned int _renderBenchStack() {
+  unsigned char *p = &__heap_start;
+  while (p < _renderBenchBase && *p == RENDER_BENCH_PAINT) {
+    ++p;
+  }
+  return _renderBenchBase - p;
+}
+#else
+void _renderBenchPaint() {}
+unsigned int _renderBenchStack() { return 0; }
+#endif
+
+blockSprite _renderBenchSprite;
+
+void _renderBenchNothing() {}
+void _renderBenchClear() { clearScreen(); }
+void _renderBenchFill() { fillRect(48, 83, 13, 25, 0x83FF); }
+void _renderBenchBlock() { drawBlock(48, 83, 0, 12); }
+void _renderBenchSpriteSetup() {
+  // one pixel right of where _renderBenchMove() puts it, so the move is a single step
+  _renderBenchSprite.drawn = false;
+  moveBlockSprite<dlDraw>(_renderBenchSprite, 92, 127, 13, 25, towerBlock);
+}
+void _renderBenchMove() { moveBlockSprite<dlDraw>(_renderBenchSprite, 91, 126, 13, 25, towerBlock); }
+void _renderBenchChar() { drawChar(109, 96, 'S', 0x0000, 0xFFFF); }
+void _renderBenchString() { drawString(109, 96, "STACKERINO", 0x0000, 0xFFFF); }
+
+const renderBenchOp renderBenchOps[] = {
+  {"clear", 0, _renderBenchClear},
+  {"fill_rect", 0, _renderBenchFill},
+  {"draw_block", 0, _renderBenchBlock},
+  {"move_block", _renderBenchSpriteSetup, _renderBenchMove},
+  {"draw_char", 0, _renderBenchChar},
+  {"draw_string", 0, _renderBenchString},
+  {"title_screen", 0, drawTitleScreen},
+  {"play_screen", 0, drawPlayScreen},
+  {"lose_screen", 0, drawLoseScreen},
+  {"win_screen", 0, drawWinScreen},
+};
+
+// Cycles, bytes and stack of one call, display list and SPI drained before and after
+unsigned long _renderBenchMeasure(void (*run)(), unsigned long &bytes, unsigned int &stack) {
+  dlFinish();
+  SPI_FLUSH();
+  _renderBenchPaint();
+  unsigned long sent = spiBytesSent;
+  unsigned long start = CYCLES_NOW();
+  run();
+  dlFinish();
+  SPI_FLUSH();
+  unsigned long cycles = CYCLES_NOW() - start;
+  bytes = spiBytesSent - sent;
+  stack = _renderBenchStack();
+  return cycles;
+}
+
+void RENDER_BENCHMARK_RUN() {
+  UART_INIT();
+  CYCLES_INIT();
+  UART_PRINT("render benchmark\r\n");
+
+  unsigned long bytes;
+  unsigned int stack;
+  unsigned long overhead = _renderBenchMeasure(_renderBenchNothing, bytes, stack);
+
+  for (unsigned char n = 0; n < sizeof(renderBenchOps) / sizeof(renderBenchOps[0]); ++n) {
+    clearScreen();
+    if (renderBenchOps[n].setup) {
+      renderBenchOps[n].setup();
+    }
+    dlFinish(); // so the setup's own savings aren't counted
+
+    unsigned long saved = st7735_frameStats.pixelsSaved;
+    unsigned long cycles = _renderBenchMeasure(renderBenchOps[n].run, bytes, stack) - overhead;
+
+    UART_PRINT("op=");
+    UART_PRINT(renderBenchOps[n].name);
+    UART_PRINT(" cycles=");
+    UART_PRINT_NUM(cycles);
+    UART_PRINT(" us=");
+    UART_PRINT_NUM(CYCLES_TO_US(cycles));
+    UART_PRINT(" spi_bytes=");
+    UART_PRINT_NUM(bytes);
+    UART_PRINT(" stack=");
+    UART_PRINT_NUM(stack);
+    UART_PRINT(" pixels_saved=");
+    UART_PRINT_NUM(st7735_frameStats.pixelsSaved - saved);
+    UART_PRINT("\r\n");
+  }
+
+  UART_PRINT("done\r\n");
+}
+
+#endif // RENDER_BENCH_H
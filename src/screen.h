@@ -0,0 +1,30 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+// Retained screens: remembers which static screen is on the panel so it is drawn once
+// when a state is entered instead of on every tick. Anything that wipes or overdraws
+// the panel outside of screenShow() (clearScreen() does) has to call screenInvalidate()
+// so the next screenShow() puts the screen back.
+
+enum screenId {SCREEN_NONE, SCREEN_TITLE, SCREEN_PLAY, SCREEN_LOSE};
+
+typedef void (*screenDrawFct)();
+
+unsigned char screenOnPanel = SCREEN_NONE;
+unsigned int screenDraws = 0; // how many times a screen actually had to be drawn
+
+void screenInvalidate() {
+  screenOnPanel = SCREEN_NONE;
+}
+
+// Draw screen id unless it is already showing. The draw function may clear the
+// panel itself, the screen only counts as shown once it returns.
+void screenShow(unsigned char id, screenDrawFct draw) {
+  if (screenOnPanel != id) {
+    draw();
+    screenOnPanel = id;
+    ++screenDraws;
+  }
+}
+
+#endif // SCREEN_H
@@ -1,9 +1,8 @@
 #ifndef SPIAVR_H
 #define SPIAVR_H
 
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include <util/delay.h>
+#include "hal.h"
+#include "gpio.h"
 
 
 //B5 should always be SCK(spi clock) and B3 should always be MOSI. If you are using an
@@ -13,23 +12,230 @@
 //devices, they will share the SCK, MOSI and MISO pins but should have different SS pins.
 //To send a value to a specific device, set it's SS pin to low and all other SS pins to high.
 
+//Transmission is interrupt driven: SPI_SEND() drops the byte into a ring buffer and returns
+//right away, and ISR(SPI_STC_vect) shifts the next byte out every time the previous one is done.
+//The queue drives PIN_SS itself: it goes low when the first byte is started and back high once
+//the ring runs dry, unless a transaction opened with SPI_BEGIN() is holding it. Anything that
+//has to line up with a byte boundary (like the A0 pin of the display) must call SPI_FLUSH() first.
+//Global interrupts have to be enabled for this to work.
+
 // Outputs, pin definitions
 #define PIN_SCK                   PORTB5//SHOULD ALWAYS BE B5 ON THE ARDUINO
 #define PIN_MOSI                  PORTB3//SHOULD ALWAYS BE B3 ON THE ARDUINO
 #define PIN_SS                    PORTB2
 
+typedef Pin<PortB, PIN_SS> SPI_SS;//the queue toggles this around transfers
+
+// Clock settings for SPI_CONFIG(): SPI2X in bit 2, SPR1:SPR0 in bits 1:0.
+// The ST7735 is happy with fosc/2 (8 MHz on a 16 MHz part).
+#define SPI_CLOCK_DIV2            0x04
+#define SPI_CLOCK_DIV4            0x00
+#define SPI_CLOCK_DIV8            0x05
+#define SPI_CLOCK_DIV16           0x01
+#define SPI_CLOCK_DIV32           0x06
+#define SPI_CLOCK_DIV64           0x02
+#define SPI_CLOCK_DIV128          0x03
+
+#define SPI_MODE0                 0x00
+#define SPI_MODE1                 (1 << CPHA)
+#define SPI_MODE2                 (1 << CPOL)
+#define SPI_MODE3                 ((1 << CPOL) | (1 << CPHA))
+
+#define SPI_MSB_FIRST             0x00
+#define SPI_LSB_FIRST             (1 << DORD)
+
+#ifndef SPI_DEFAULT_CLOCK
+#define SPI_DEFAULT_CLOCK         SPI_CLOCK_DIV2//override with -DSPI_DEFAULT_CLOCK=... if a panel can't keep up
+#endif
+
+#define SPI_TX_BUFFER_SIZE        64//MUST BE A POWER OF TWO, max 128
+#define SPI_TX_BUFFER_MASK        (SPI_TX_BUFFER_SIZE - 1)
+
+volatile unsigned char _spi_tx_buffer[SPI_TX_BUFFER_SIZE];
+volatile unsigned char _spi_tx_head = 0; // next free slot, only written by SPI_TRY_SEND()
+volatile unsigned char _spi_tx_tail = 0; // next byte to shift out, only written by the ISR
+volatile unsigned char _spi_tx_busy = 0; // 1 while a byte is in SPDR
+volatile unsigned char _spi_tx_hold = 0; // 1 between SPI_BEGIN() and SPI_END()
+
+// Bytes handed to the SPI since reset, only with -DSPI_COUNT_BYTES (the render benchmark
+// builds with it). Counted once per call rather than per byte so the polled fill loop
+// keeps its timing.
+#ifdef SPI_COUNT_BYTES
+unsigned long spiBytesSent = 0;
+#define _SPI_COUNT(n) (spiBytesSent += (n))
+#else
+#define _SPI_COUNT(n)
+#endif
+
+
+// Pick the clock divider, SPI mode and bit order. Waits for queued bytes first
+// so nothing already in the ring goes out at the new rate.
+void SPI_CONFIG(unsigned char clock, unsigned char mode, unsigned char bitOrder)
+{
+    while (_spi_tx_busy) {//same as SPI_FLUSH()
+        HAL_POLL();
+    }
+    SPCR = (SPCR & ~((1 << CPOL) | (1 << CPHA) | (1 << DORD) | (1 << SPR1) | (1 << SPR0)))
+         | mode | bitOrder | (clock & 0x03);
+    if (clock & 0x04) {
+        SPSR |= (1 << SPI2X);
+    }
+    else {
+        SPSR &= ~(1 << SPI2X);
+    }
+}
+
 
 //If SS is on a different port, make sure to change the init to take that into account.
 void SPI_INIT(){
     DDRB |= (1 << PIN_SCK) | (1 << PIN_MOSI) | (1 << PIN_SS);//initialize your pins. 
-    SPCR |= (1 << SPE) | (1 << MSTR); //initialize SPI coomunication
+    SPI_SS::set();//deselect until there is something to send
+    SPCR |= (1 << SPE) | (1 << MSTR) | (1 << SPIE); //initialize SPI coomunication
+    SPI_CONFIG(SPI_DEFAULT_CLOCK, SPI_MODE0, SPI_MSB_FIRST);
 }
 
 
+// Non-blocking enqueue. Returns false without queueing anything if the ring is full.
+bool SPI_TRY_SEND(char data)
+{
+    bool queued = true;
+    unsigned char sreg = SREG;
+    cli();
+    if (!_spi_tx_busy) {
+        SPI_SS::clear();
+        _spi_tx_busy = 1;
+        SPDR = data;//bus is idle, start right away
+    }
+    else {
+        unsigned char next = (_spi_tx_head + 1) & SPI_TX_BUFFER_MASK;
+        if (next == _spi_tx_tail) {
+            queued = false;//full
+        }
+        else {
+            _spi_tx_buffer[_spi_tx_head] = data;
+            _spi_tx_head = next;
+        }
+    }
+    SREG = sreg;
+    if (queued) {
+        _SPI_COUNT(1);
+    }
+    return queued;
+}
+
+
+// Queue a byte, waiting for a free slot if the ring is full (back-pressure).
 void SPI_SEND(char data)
 {
-    SPDR = data;//set data that you want to transmit
-    while (!(SPSR & (1 << SPIF)));// wait until done transmitting
+    while (!SPI_TRY_SEND(data));
+}
+
+
+// True while bytes are queued or still shifting out.
+bool SPI_BUSY()
+{
+    return _spi_tx_busy;
+}
+
+
+// Wait until every queued byte has left the shift register.
+void SPI_FLUSH()
+{
+    while (_spi_tx_busy) {
+        HAL_POLL();
+    }
+}
+
+
+// Select the device and keep it selected until SPI_END(), even if the ring runs dry
+// in between. Use this around a stream of bytes so SS toggles once for all of it.
+void SPI_BEGIN()
+{
+    _spi_tx_hold = 1;
+    SPI_SS::clear();
+}
+
+
+// Let the queued bytes finish, then release the device.
+void SPI_END()
+{
+    SPI_FLUSH();
+    _spi_tx_hold = 0;
+    SPI_SS::set();
+}
+
+
+// Send a 16 bit value count times, high byte first, without going through the ring.
+// At fosc/2 a byte takes 16 cycles, less than the interrupt that would queue the next
+// one, so long fills wait on SPIF directly and the loop is unrolled to 4 values per pass
+// to keep the bookkeeping between bytes small.
+#define _SPI_PUT(b) do { SPDR = (b); while (!(SPSR & (1 << SPIF))); } while (0)
+
+void SPI_SEND_REPEAT16(unsigned int value, unsigned long count)
+{
+    unsigned char hi = value >> 8;
+    unsigned char lo = value & 0xFF;
+
+    SPI_FLUSH();
+    _SPI_COUNT(count * 2);
+    SPCR &= ~(1 << SPIE);//no interrupt per byte while polling
+    SPI_SS::clear();
+
+    for (unsigned long blocks = count >> 2; blocks; --blocks) {
+        _SPI_PUT(hi); _SPI_PUT(lo);
+        _SPI_PUT(hi); _SPI_PUT(lo);
+        _SPI_PUT(hi); _SPI_PUT(lo);
+        _SPI_PUT(hi); _SPI_PUT(lo);
+    }
+    for (unsigned char rest = count & 0x03; rest; --rest) {
+        _SPI_PUT(hi); _SPI_PUT(lo);
+    }
+
+    (void)SPDR;//SPSR was read with SPIF set, reading SPDR clears it
+    SPCR |= (1 << SPIE);
+    if (!_spi_tx_hold) {
+        SPI_SS::set();
+    }
+}
+
+
+// Send the 3 bytes b0 b1 b2 count times, same polled path as SPI_SEND_REPEAT16().
+// A 12 bit pixel pair is 3 bytes, so this is the fill of the 12 bit color mode.
+void SPI_SEND_REPEAT24(unsigned char b0, unsigned char b1, unsigned char b2, unsigned long count)
+{
+    SPI_FLUSH();
+    _SPI_COUNT(count * 3);
+    SPCR &= ~(1 << SPIE);//no interrupt per byte while polling
+    SPI_SS::clear();
+
+    for (unsigned long blocks = count >> 1; blocks; --blocks) {
+        _SPI_PUT(b0); _SPI_PUT(b1); _SPI_PUT(b2);
+        _SPI_PUT(b0); _SPI_PUT(b1); _SPI_PUT(b2);
+    }
+    if (count & 0x01) {
+        _SPI_PUT(b0); _SPI_PUT(b1); _SPI_PUT(b2);
+    }
+
+    (void)SPDR;//SPSR was read with SPIF set, reading SPDR clears it
+    SPCR |= (1 << SPIE);
+    if (!_spi_tx_hold) {
+        SPI_SS::set();
+    }
+}
+
+
+ISR(SPI_STC_vect)
+{
+    if (_spi_tx_tail != _spi_tx_head) {
+        SPDR = _spi_tx_buffer[_spi_tx_tail];
+        _spi_tx_tail = (_spi_tx_tail + 1) & SPI_TX_BUFFER_MASK;
+    }
+    else {
+        _spi_tx_busy = 0;
+        if (!_spi_tx_hold) {
+            SPI_SS::set();//done, release the device
+        }
+    }
 }
 
-#endif /* SPIAVR_H */
\ No newline at end of file
+#endif /* SPIAVR_H */
@@ -0,0 +1,83 @@
+#ifndef SPI_BENCH_H
+#define SPI_BENCH_H
+
+#include "cycles.h"
+#include "spi.h"
+#include "st7735.h"
+#include "uart.h"
+
+// SPI throughput benchmark, built with -DSPI_BENCHMARK (pio run -e spi_bench -t upload,
+// then pio device monitor). For every clock setting it streams a block of raw bytes and
+// then clears the whole panel, and prints one line per setting:
+//
+//   div=2 2x=1 bytes=4096 cycles=... bytes_per_s=... clear_us=...
+//
+// Each clear uses a different color so a setting the panel can't keep up with shows up
+// as garbage on the screen.
+
+#define SPI_BENCH_BYTES 4096
+
+struct spiBenchSetting {
+  unsigned char clock;
+  unsigned char divider;
+};
+
+const spiBenchSetting spiBenchSettings[] = {
+  {SPI_CLOCK_DIV2, 2},
+  {SPI_CLOCK_DIV4, 4},
+  {SPI_CLOCK_DIV8, 8},
+  {SPI_CLOCK_DIV16, 16},
+  {SPI_CLOCK_DIV32, 32},
+  {SPI_CLOCK_DIV64, 64},
+  {SPI_CLOCK_DIV128, 128},
+};
+
+const unsigned int spiBenchColors[] = {0xF800, 0x07E0, 0x001F, 0xFFE0, 0xF81F, 0x07FF, 0x0000};
+
+void SPI_BENCHMARK_RUN() {
+  UART_INIT();
+  CYCLES_INIT();
+  UART_PRINT("spi benchmark\r\n");
+
+  for (unsigned char s = 0; s < sizeof(spiBenchSettings) / sizeof(spiBenchSettings[0]); ++s) {
+    SPI_CONFIG(spiBenchSettings[s].clock, SPI_MODE0, SPI_MSB_FIRST);
+
+    // raw byte stream into the top of the panel, window setup not timed
+    st7735_begin();
+    st7735_window(0, 127, 0, 127);
+    unsigned long start = CYCLES_NOW();
+    for (unsigned int i = 0; i < SPI_BENCH_BYTES; ++i) {
+      SPI_SEND(0x00);
+    }
+    SPI_FLUSH();
+    unsigned long streamCycles = CYCLES_NOW() - start;
+    st7735_end();
+
+    // full screen clear, same path as clearScreen()
+    start = CYCLES_NOW();
+    st7735_begin();
+    st7735_window(0, 127, 0, 127);
+    st7735_fill(spiBenchColors[s], 128UL * 128UL);
+    st7735_end();
+    unsigned long clearCycles = CYCLES_NOW() - start;
+
+    UART_PRINT("div=");
+    UART_PRINT_NUM(spiBenchSettings[s].divider);
+    UART_PRINT(" 2x=");
+    UART_PRINT_NUM((spiBenchSettings[s].clock & 0x04) ? 1 : 0);
+    UART_PRINT(" bytes=");
+    UART_PRINT_NUM(SPI_BENCH_BYTES);
+    UART_PRINT(" cycles=");
+    UART_PRINT_NUM(streamCycles);
+    UART_PRINT(" bytes_per_s=");
+    UART_PRINT_NUM((unsigned long)((unsigned long long)SPI_BENCH_BYTES * F_CPU / streamCycles));
+    UART_PRINT(" clear_us=");
+    UART_PRINT_NUM(CYCLES_TO_US(clearCycles));
+    UART_PRINT("\r\n");
+  }
+
+  SPI_CONFIG(SPI_DEFAULT_CLOCK, SPI_MODE0, SPI_MSB_FIRST);
+  UART_PRINT("done\r\n");
+}
+
+#endif // SPI_BENCH_H
@@ -0,0 +1,486 @@
+#ifndef ST7735_H
+#define ST7735_H
+
+#include "hal.h"
+#include "gpio.h"
+#include "spi.h"
+
+typedef SPI_SS LCD_CS; // PORTB2, driven by the SPI queue (see spi.h)
+typedef Pin<PortD, PORTD7> LCD_A0;
+typedef Pin<PortD, PORTD6> LCD_RESET;
+
+// Commands used by the game, see the ST7735 datasheet
+#define ST7735_SWRESET 0x01
+#define ST7735_SLPOUT  0x11
+#define ST7735_DISPON  0x29
+#define ST7735_CASET   0x2A
+#define ST7735_RASET   0x2B
+#define ST7735_RAMWR   0x2C
+#define ST7735_VSCRDEF 0x33
+#define ST7735_VSCRSADD 0x37
+#define ST7735_COLMOD  0x3A
+
+#define ST7735_FRAME_ROWS 162 // lines of frame memory, a scroll area has to add up to this
+
+// Pixel format, 16 (RGB565, 2 bytes a pixel) or 12 (RGB444, 3 bytes for 2 pixels).
+// Colors are always given as RGB565; in 12 bit mode the low bits of each channel are
+// dropped on the way out, so the screens look slightly different (and don't match the
+// golden frames in test/). Build with -DST7735_COLOR_BITS=12 to use it.
+#ifndef ST7735_COLOR_BITS
+#define ST7735_COLOR_BITS 16
+#endif
+
+#if ST7735_COLOR_BITS == 12
+#define ST7735_COLMOD_PIXELS 0x03
+#else
+#define ST7735_COLMOD_PIXELS 0x05
+#endif
+
+// Bring-up timing from the datasheet, the least each step has to wait
+#define ST7735_RESET_PULSE_US 10  // RESX low
+#define ST7735_RESET_WAIT_MS  5   // RESX high to the first command (panel is in sleep in)
+#define ST7735_SLPOUT_AFTER_RESET_MS 120 // RESX high to SLPOUT
+#define ST7735_SLPOUT_WAIT_MS 5   // SLPOUT to the next command
+
+// CS is driven by the SPI queue (see spi.h), so only A0 is handled here.
+// A0 may only change once everything queued before it has been shifted out.
+void _st7735_flushPixel();
+void _st7735_dirtyCover(int xStart, int xEnd, int yStart, int yEnd);
+void st7735_flushDirty();
+void st7735_dropDirty();
+
+void cmd_st7735(unsigned char cmd) {
+  _st7735_flushPixel(); // a half finished 12 bit pair goes out before the command
+  SPI_FLUSH();
+  // TODO: set A0 pin LOW
+  LCD_A0::clear();
+  SPI_SEND(cmd);
+  SPI_FLUSH();
+  // A0 HIGH: everything after the command is data
+  LCD_A0::set();
+}
+
+void dat_st7735(unsigned char dat) {
+  SPI_SEND(dat);
+}
+
+
+void HardwareReset(){
+  LCD_A0::output();
+  LCD_RESET::output();
+  // TODO: set RESET pin LOW
+  LCD_RESET::clear();
+  _delay_ms(200);
+  // TODO: set RESET pin HIGH
+  LCD_RESET::set();
+  _delay_ms(200);
+}
+
+/*****************************************************************************/
+// Window cache: CASET/RASET are only sent when the column or row range differs
+// from what the panel already has. RAMWR always goes out since it is what moves
+// the write pointer back to the top left of the window.
+
+struct st7735WindowStats {
+  unsigned int casetSkipped; // CASET commands not sent
+  unsigned int rasetSkipped; // RASET commands not sent
+  unsigned int bytesSaved;   // 5 bytes (command + 4 parameters) per skipped command
+  unsigned long pixelsSaved; // fill pixels not sent because they were drawn over (see st7735_fillRect())
+  unsigned int fillsMerged;  // fills sent as part of a neighbour's window
+};
+
+int _st7735_colStart, _st7735_colEnd, _st7735_rowStart, _st7735_rowEnd;
+bool _st7735_windowValid = false;
+
+st7735WindowStats st7735_frameStats;     // counting since the last st7735_endFrame()
+st7735WindowStats st7735_lastFrameStats; // totals of the previous frame
+
+// Forget the cached window, e.g. after a reset put the panel back to its defaults
+void st7735_invalidateWindow() {
+  _st7735_windowValid = false;
+}
+
+// Close the current frame's counters, call once per pass of the main loop
+void st7735_endFrame() {
+  st7735_lastFrameStats = st7735_frameStats;
+  st7735_frameStats.casetSkipped = 0;
+  st7735_frameStats.rasetSkipped = 0;
+  st7735_frameStats.bytesSaved = 0;
+  st7735_frameStats.pixelsSaved = 0;
+  st7735_frameStats.fillsMerged = 0;
+  HAL_FRAME_END();
+}
+/*****************************************************************************/
+
+void st7735_init(){
+  st7735_invalidateWindow();
+  HardwareReset();
+  cmd_st7735(ST7735_SWRESET);
+  _delay_ms(150);
+  cmd_st7735(ST7735_SLPOUT);
+  _delay_ms(200);
+  cmd_st7735(ST7735_COLMOD);
+  dat_st7735(ST7735_COLMOD_PIXELS);
+  _delay_ms(10);
+  cmd_st7735(ST7735_DISPON);
+  _delay_ms(200);
+}
+
+/*****************************************************************************/
+// Bring-up in steps, for a caller that waits the ST7735_*_MS times between them
+// without blocking (the game does it in tickFctPanel). The hardware reset already
+// does what SWRESET would. Frame memory takes pixels from st7735_setup() on, while
+// the panel is still asleep, so the first screen can be drawn before st7735_displayOn().
+
+// RESX low, then st7735_resetEnd() ST7735_RESET_PULSE_US later
+void st7735_resetBegin() {
+  st7735_invalidateWindow();
+  st7735_dropDirty();
+  LCD_A0::output();
+  LCD_RESET::output();
+  LCD_RESET::clear();
+}
+
+void st7735_resetEnd() {
+  LCD_RESET::set();
+}
+
+// ST7735_RESET_WAIT_MS after st7735_resetEnd(): pixel format
+void st7735_setup() {
+  cmd_st7735(ST7735_COLMOD);
+  dat_st7735(ST7735_COLMOD_PIXELS);
+}
+
+// ST7735_SLPOUT_AFTER_RESET_MS after st7735_resetEnd()
+void st7735_sleepOut() {
+  cmd_st7735(ST7735_SLPOUT);
+}
+
+// ST7735_SLPOUT_WAIT_MS after st7735_sleepOut()
+void st7735_displayOn() {
+  cmd_st7735(ST7735_DISPON);
+}
+/*****************************************************************************/
+
+/*****************************************************************************/
+// Transactions: keep CS asserted for a whole command + pixel stream instead of
+// once per byte. Every draw looks like
+//
+//   st7735_begin();
+//   st7735_window(xStart, xEnd, yStart, yEnd);
+//   st7735_fill(color, count);   // and/or st7735_pixel() / st7735_write()
+//   st7735_end();
+
+void st7735_begin() {
+  SPI_BEGIN();
+}
+
+void st7735_end() {
+  _st7735_flushPixel();
+  SPI_END();
+}
+
+// Command followed by its parameter bytes
+void st7735_command(unsigned char cmd, const unsigned char *params, unsigned char count) {
+  cmd_st7735(cmd);
+  for (unsigned char i = 0; i < count; ++i) {
+    SPI_SEND(params[i]);
+  }
+}
+
+// CASET + RASET + RAMWR: after this every pixel goes into the given window,
+// left to right, top to bottom. CASET/RASET are skipped if they wouldn't change anything.
+// The caller has to write the whole window (fills waiting under it are cut away).
+void st7735_window(int xStart, int xEnd, int yStart, int yEnd) {
+  _st7735_dirtyCover(xStart, xEnd, yStart, yEnd);
+  if (_st7735_windowValid && xStart == _st7735_colStart && xEnd == _st7735_colEnd) {
+    ++st7735_frameStats.casetSkipped;
+    st7735_frameStats.bytesSaved += 5;
+  }
+  else {
+    unsigned char cols[4] = {(unsigned char)(xStart >> 8), (unsigned char)(xStart & 0xFF),
+                             (unsigned char)(xEnd >> 8), (unsigned char)(xEnd & 0xFF)};
+    st7735_command(ST7735_CASET, cols, 4);
+    _st7735_colStart = xStart;
+    _st7735_colEnd = xEnd;
+  }
+
+  if (_st7735_windowValid && yStart == _st7735_rowStart && yEnd == _st7735_rowEnd) {
+    ++st7735_frameStats.rasetSkipped;
+    st7735_frameStats.bytesSaved += 5;
+  }
+  else {
+    unsigned char rows[4] = {(unsigned char)(yStart >> 8), (unsigned char)(yStart & 0xFF),
+                             (unsigned char)(yEnd >> 8), (unsigned char)(yEnd & 0xFF)};
+    st7735_command(ST7735_RASET, rows, 4);
+    _st7735_rowStart = yStart;
+    _st7735_rowEnd = yEnd;
+  }
+
+  _st7735_windowValid = true;
+  cmd_st7735(ST7735_RAMWR);
+}
+
+/*****************************************************************************/
+// Vertical scrolling: the top and bottom lines stay put, the height lines between them
+// become a ring that st7735_scrollTo() turns without redrawing anything.
+// top + height + bottom must be ST7735_FRAME_ROWS; after a reset it is 0, 162, 0.
+
+void st7735_scrollArea(unsigned int top, unsigned int height, unsigned int bottom) {
+  unsigned char params[6] = {(unsigned char)(top >> 8), (unsigned char)(top & 0xFF),
+                             (unsigned char)(height >> 8), (unsigned char)(height & 0xFF),
+                             (unsigned char)(bottom >> 8), (unsigned char)(bottom & 0xFF)};
+  st7735_begin();
+  st7735_command(ST7735_VSCRDEF, params, 6);
+  st7735_end();
+}
+
+// Show frame memory line `line` on the first line of the scroll area
+void st7735_scrollTo(unsigned int line) {
+  unsigned char params[2] = {(unsigned char)(line >> 8), (unsigned char)(line & 0xFF)};
+  st7735_begin();
+  st7735_command(ST7735_VSCRSADD, params, 2);
+  st7735_end();
+}
+/*****************************************************************************/
+
+#if ST7735_COLOR_BITS == 12
+// 12 bit pixels go out in pairs, RRRRGGGG BBBBrrrr ggggbbbb. A pixel without a partner
+// yet waits here for the next st7735_pixel()/st7735_fill(); if the stream ends first
+// (st7735_end() or the next command) it goes out alone as 2 bytes, which the panel
+// takes as a whole pixel followed by a partial one it drops.
+unsigned int _st7735_halfPair; // 0x0RGB
+bool _st7735_hasHalfPair = false;
+
+// RGB565 to 0x0RGB, 4 bits per channel
+unsigned int st7735_color12(unsigned int color) {
+  return ((color >> 4) & 0xF00) | ((color >> 3) & 0x0F0) | ((color >> 1) & 0x00F);
+}
+
+void _st7735_pair(unsigned int first, unsigned int second) {
+  SPI_SEND(first >> 4);
+  SPI_SEND(((first & 0x0F) << 4) | (second >> 8));
+  SPI_SEND(second & 0xFF);
+}
+
+void _st7735_flushPixel() {
+  if (_st7735_hasHalfPair) {
+    _st7735_hasHalfPair = false;
+    SPI_SEND(_st7735_halfPair >> 4);
+    SPI_SEND((_st7735_halfPair & 0x0F) << 4);
+  }
+}
+
+void st7735_pixel(unsigned int color) {
+  unsigned int c = st7735_color12(color);
+  if (_st7735_hasHalfPair) {
+    _st7735_hasHalfPair = false;
+    _st7735_pair(_st7735_halfPair, c);
+  }
+  else {
+    _st7735_halfPair = c;
+    _st7735_hasHalfPair = true;
+  }
+}
+
+// The same color count times, 3 bytes per 2 pixels on the polled path
+void st7735_fill(unsigned int color, unsigned long count) {
+  if (!count) {
+    return;
+  }
+  unsigned int c = st7735_color12(color);
+  if (_st7735_hasHalfPair) {
+    _st7735_hasHalfPair = false;
+    _st7735_pair(_st7735_halfPair, c);
+    --count;
+  }
+  if (count > 1) {
+    SPI_SEND_REPEAT24(c >> 4, ((c & 0x0F) << 4) | (c >> 8), c & 0xFF, count >> 1);
+  }
+  if (count & 1) {
+    _st7735_halfPair = c;
+    _st7735_hasHalfPair = true;
+  }
+}
+#else
+void _st7735_flushPixel() {}
+
+// One RGB565 pixel, high byte first
+void st7735_pixel(unsigned int color) {
+  SPI_SEND(color >> 8);
+  SPI_SEND(color & 0xFF);
+}
+
+// The same color count times, polled fast path (see SPI_SEND_REPEAT16)
+void st7735_fill(unsigned int color, unsigned long count) {
+  SPI_SEND_REPEAT16(color, count);
+}
+#endif
+
+// Raw bytes in the panel's pixel format, e.g. a row of pixels that was built up front
+void st7735_write(const unsigned char *buffer, unsigned int length) {
+  for (unsigned int i = 0; i < length; ++i) {
+    SPI_SEND(buffer[i]);
+  }
+}
+/*****************************************************************************/
+
+/*****************************************************************************/
+// Dirty rectangles: solid fills made with st7735_fillRect() wait for st7735_flushDirty()
+// or st7735_flushDirtySome() instead of going out straight away (the display list
+// sends them when it has nothing else to draw, see displaylist.h). Every window opened after one cuts the
+// area it covers out of the fills still waiting, so pixels that would be drawn over
+// in the same frame are never sent: a clear followed by text only sends the clear
+// around the text, a fill over an older one replaces it, and one that is drawn over
+// completely is dropped. A fill touching a waiting fill of the same color along a
+// whole side is merged into its window. The fills that are left never overlap each
+// other or anything drawn after them, so they can go out in any order.
+//
+// Cutting a rectangle out of a fill leaves up to four pieces. When they don't fit
+// in ST7735_DIRTY_MAX, everything waiting is sent first, which is just as correct.
+
+#ifndef ST7735_DIRTY_MAX
+#define ST7735_DIRTY_MAX 8
+#endif
+
+struct _st7735_dirtyRect {
+  int xStart, xEnd, yStart, yEnd; // inclusive
+  unsigned int color;
+};
+
+_st7735_dirtyRect _st7735_dirty[ST7735_DIRTY_MAX];
+unsigned char _st7735_dirtyCount = 0;
+bool _st7735_dirtyFlushing = false; // the windows st7735_flushDirty() opens cut nothing
+
+void _st7735_dirtyAdd(int xStart, int xEnd, int yStart, int yEnd, unsigned int color) {
+  _st7735_dirtyRect &r = _st7735_dirty[_st7735_dirtyCount++];
+  r.xStart = xStart;
+  r.xEnd = xEnd;
+  r.yStart = yStart;
+  r.yEnd = yEnd;
+  r.color = color;
+}
+
+// Inside a caller's transaction (an overflow from st7735_window()) the fill goes out
+// in it: an own st7735_end() would release CS under the caller's window.
+void _st7735_dirtySend(int xStart, int xEnd, int yStart, int yEnd, unsigned int color) {
+  bool inTransaction = _spi_tx_hold;
+  _st7735_dirtyFlushing = true;
+  if (!inTransaction) {
+    st7735_begin();
+  }
+  st7735_window(xStart, xEnd, yStart, yEnd);
+  st7735_fill(color, (unsigned long)((xEnd - xStart) + 1) * ((yEnd - yStart) + 1));
+  if (!inTransaction) {
+    st7735_end();
+  }
+  _st7735_dirtyFlushing = false;
+}
+
+// Send every waiting fill
+void st7735_flushDirty() {
+  for (unsigned char i = 0; i < _st7735_dirtyCount; ++i) {
+    const _st7735_dirtyRect &r = _st7735_dirty[i];
+    _st7735_dirtySend(r.xStart, r.xEnd, r.yStart, r.yEnd, r.color);
+  }
+  _st7735_dirtyCount = 0;
+}
+
+// Send whole rows of one waiting fill, about pixels of them (at least a row).
+// Returns false if nothing was waiting.
+bool st7735_flushDirtySome(unsigned int pixels) {
+  if (!_st7735_dirtyCount) {
+    return false;
+  }
+  _st7735_dirtyRect &r = _st7735_dirty[_st7735_dirtyCount - 1];
+  int rows = pixels / ((r.xEnd - r.xStart) + 1);
+  if (rows < 1) {
+    rows = 1;
+  }
+  if (r.yStart + rows > r.yEnd) {
+    --_st7735_dirtyCount;
+    _st7735_dirtySend(r.xStart, r.xEnd, r.yStart, r.yEnd, r.color);
+  }
+  else {
+    _st7735_dirtySend(r.xStart, r.xEnd, r.yStart, r.yStart + rows - 1, r.color);
+    r.yStart += rows;
+  }
+  return true;
+}
+
+bool st7735_dirtyPending() {
+  return _st7735_dirtyCount != 0;
+}
+
+// Forget the waiting fills without sending them, e.g. when the panel is reset
+void st7735_dropDirty() {
+  _st7735_dirtyCount = 0;
+}
+
+// The window is about to be drawn over, cut it out of the waiting fills
+void _st7735_dirtyCover(int xStart, int xEnd, int yStart, int yEnd) {
+  if (_st7735_dirtyFlushing) {
+    return;
+  }
+  unsigned char i = 0;
+  while (i < _st7735_dirtyCount) {
+    _st7735_dirtyRect r = _st7735_dirty[i];
+    int xs = (xStart > r.xStart) ? xStart : r.xStart; // the overlap
+    int xe = (xEnd < r.xEnd) ? xEnd : r.xEnd;
+    int ys = (yStart > r.yStart) ? yStart : r.yStart;
+    int ye = (yEnd < r.yEnd) ? yEnd : r.yEnd;
+    if (xs > xe || ys > ye) {
+      ++i;
+      continue;
+    }
+    unsigned char pieces = (ys > r.yStart) + (ye < r.yEnd) + (xs > r.xStart) + (xe < r.xEnd);
+    if (_st7735_dirtyCount - 1 + pieces > ST7735_DIRTY_MAX) {
+      st7735_flushDirty();
+      return;
+    }
+    st7735_frameStats.pixelsSaved += (unsigned long)((xe - xs) + 1) * ((ye - ys) + 1);
+    _st7735_dirty[i] = _st7735_dirty[--_st7735_dirtyCount]; // i is looked at again
+    if (ys > r.yStart) {
+      _st7735_dirtyAdd(r.xStart, r.xEnd, r.yStart, ys - 1, r.color);
+    }
+    if (ye < r.yEnd) {
+      _st7735_dirtyAdd(r.xStart, r.xEnd, ye + 1, r.yEnd, r.color);
+    }
+    if (xs > r.xStart) {
+      _st7735_dirtyAdd(r.xStart, xs - 1, ys, ye, r.color);
+    }
+    if (xe < r.xEnd) {
+      _st7735_dirtyAdd(xe + 1, r.xEnd, ys, ye, r.color);
+    }
+  }
+}
+
+// Solid fill of the window, corners inclusive; goes out with st7735_flushDirty() at the latest
+void st7735_fillRect(int xStart, int xEnd, int yStart, int yEnd, unsigned int color) {
+  _st7735_dirtyCover(xStart, xEnd, yStart, yEnd);
+  for (unsigned char i = 0; i < _st7735_dirtyCount; ++i) {
+    _st7735_dirtyRect &r = _st7735_dirty[i];
+    if (r.color != color) {
+      continue;
+    }
+    if (r.xStart == xStart && r.xEnd == xEnd && (r.yEnd + 1 == yStart || yEnd + 1 == r.yStart)) {
+      r.yStart = (yStart < r.yStart) ? yStart : r.yStart;
+      r.yEnd = (yEnd > r.yEnd) ? yEnd : r.yEnd;
+      ++st7735_frameStats.fillsMerged;
+      return;
+    }
+    if (r.yStart == yStart && r.yEnd == yEnd && (r.xEnd + 1 == xStart || xEnd + 1 == r.xStart)) {
+      r.xStart = (xStart < r.xStart) ? xStart : r.xStart;
+      r.xEnd = (xEnd > r.xEnd) ? xEnd : r.xEnd;
+      ++st7735_frameStats.fillsMerged;
+      return;
+    }
+  }
+  if (_st7735_dirtyCount == ST7735_DIRTY_MAX) {
+    st7735_flushDirty();
+  }
+  _st7735_dirtyAdd(xStart, xEnd, yStart, yEnd, color);
+}
+/*****************************************************************************/
+
+#endif // ST7735_H
@@ -0,0 +1,64 @@
+#ifndef TASKSTATS_H
+#define TASKSTATS_H
+
+#include "cycles.h"
+#include "timer.h"
+
+// Per task execution statistics. Tick durations are measured in CPU cycles with the
+// Timer1 counter from cycles.h, period jitter in scheduler ticks (64 us, see timer.h).
+
+struct taskStats {
+  unsigned long lastCycles;      // duration of the most recent tick
+  unsigned long maxCycles;       // longest tick so far
+  unsigned long totalCycles;     // sum of the last averaged ticks, for the average
+  unsigned long averaged;        // ticks in totalCycles, halved with it before it overflows
+  unsigned long runs;            // ticks measured
+  unsigned int missed;           // ticks that ran past the task's next deadline
+  unsigned long lastJitter;      // |measured period - configured period| of the most recent tick
+  unsigned long maxJitter;       // largest of those so far
+};
+
+void taskStatsReset(taskStats &stats) {
+  stats.lastCycles = 0;
+  stats.maxCycles = 0;
+  stats.totalCycles = 0;
+  stats.averaged = 0;
+  stats.runs = 0;
+  stats.missed = 0;
+  stats.lastJitter = 0;
+  stats.maxJitter = 0;
+}
+
+// One tick that took cycles to run and started actualPeriod ticks after the previous
+// one although period was configured. The first tick has no previous one, so it
+// counts no jitter.
+void taskStatsRecord(taskStats &stats, unsigned long cycles, unsigned long actualPeriod, unsigned long period) {
+  stats.lastCycles = cycles;
+  if (cycles > stats.maxCycles) {
+    stats.maxCycles = cycles;
+  }
+  if (stats.totalCycles > 0xFFFFFFFFUL - cycles) {
+    stats.totalCycles >>= 1;
+    stats.averaged >>= 1;
+  }
+  stats.totalCycles += cycles;
+  ++stats.averaged;
+  if (++stats.runs == 1) {
+    return;
+  }
+
+  stats.lastJitter = (actualPeriod > period) ? actualPeriod - period : period - actualPeriod;
+  if (stats.lastJitter > stats.maxJitter) {
+    stats.maxJitter = stats.lastJitter;
+  }
+}
+
+void taskStatsMissed(taskStats &stats) {
+  ++stats.missed;
+}
+
+unsigned long taskStatsAverage(const taskStats &stats) {
+  return stats.averaged ? stats.totalCycles / stats.averaged : 0;
+}
+
+#endif // TASKSTATS_H
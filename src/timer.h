@@ -4,62 +4,30 @@
 #ifndef TIMER_H
 #define TIMER_H
 
-#include <avr/interrupt.h>
-#include <avr/io.h>
-#include <util/delay.h>
+#include "hal.h"
 
+// Tickless timer: instead of interrupting every 1 ms, Timer2 counts freely and the
+// scheduler asks to be woken at the exact tick its next task is due. In between the
+// CPU sits in idle sleep (SPI and the other timers keep running there).
+//
+// Timer2 runs at 16 MHz / 1024 = 15,625 counts/s, so one tick is 64 us. The overflow
+// interrupt (every 256 ticks, 16.4 ms) extends the count to 32 bits, which wraps
+// after about 76 hours. Compare the difference of two times, never the times
+// themselves, and it keeps working across the wrap.
 
-volatile unsigned char TimerFlag = 0; // TimerISR() sets this to 1. C programmer should clear to 0.
+#define TIMER_US_PER_TICK 64
+#define TIMER_MS_TO_TICKS(ms) ((((unsigned long)(ms)) * 125UL + 4) / 8) // 15.625 ticks per ms
+#define TIMER_TICKS_TO_US(ticks) (((unsigned long)(ticks)) * TIMER_US_PER_TICK)
 
-// Internal variables for mapping AVR's ISR to our cleaner TimerISR model.
-unsigned long _avr_timer_M = 1; // Start count from here, down to 0. Default 1ms
-unsigned long _avr_timer_cntcurr = 0; // Current internal count of 1ms ticks
-
-void TimerISR(void) {
-	TimerFlag = true;
-}
-
-// Set TimerISR() to tick every M ms
-void TimerSet(unsigned long M) {
-	_avr_timer_M = M;
-	_avr_timer_cntcurr = _avr_timer_M;
-}
+volatile unsigned long _avr_timer_overflows = 0; // count of Timer2 overflows
 
 void TimerOn() {
-	// AVR timer/counter controller register TCCR1
-	TCCR2A = 0x02;
-    TCCR2B 	= 0x04;	// bit3 = 1: CTC mode (clear timer on compare)
-					// bit2bit1bit0=011: prescaler /64
-					// 00001011: 0x0B
-					// SO, 16 MHz clock or 16,000,000 /64 = 250,000 ticks/s
-					// Thus, TCNT1 register will count at 250,000 ticks/s
-          // FOR MICROSECONDS:
-          // bit3 = 1: CTC mode (clear timer on compare)
-					// bit2bit1bit0=010: prescaler /64
-					// 00001010: 0x0A
-					// SO, 16 MHz clock or 16,000,000 /8 = 2,000,000 ticks/s
-					// Thus, TCNT1 register will count at 2,000,000 ticks/s
-
-	// AVR output compare register OCR1A.
-	OCR2A 	= 250;	// Timer interrupt will be generated when TCNT1==OCR1A
-					// We want a 1 ms tick. 0.001 s * 250,000 ticks/s = 250
-					// So when TCNT1 register equals 250,
-					// 1 ms has passed. Thus, we compare to 250.
-					// AVR timer interrupt mask register
-          // FOR MICROSECONDS:
-          // Timer interrupt will be generated when TCNT1==OCR1A
-					// We want a 1 us tick. 0.000001 s * 2,000,000 ticks/s = 2
-					// So when TCNT1 register equals 2,
-					// 1 us has passed. Thus, we compare to 2.
-					// AVR timer interrupt mask register
-
-	TIMSK2 	= 0x02; // bit1: OCIE1A -- enables compare match interrupt
-
-	//Initialize avr counter
+	TCCR2A 	= 0x00;	// normal mode, count 0..255 and wrap
+	TCCR2B 	= 0x07;	// bit2bit1bit0=111: prescaler /1024
+					// 16,000,000 / 1024 = 15,625 ticks/s, 64 us each
 	TCNT2 = 0;
-
-	// TimerISR will be called every _avr_timer_cntcurr milliseconds
-	_avr_timer_cntcurr = _avr_timer_M;
+	TIFR2 = (1 << OCF2A) | (1 << TOV2);	// drop anything left over
+	TIMSK2 	= (1 << TOIE2);	// overflow interrupt only, the compare is armed per sleep
 
 	//Enable global interrupts
 	SREG |= 0x80;	// 0x80: 1000000
@@ -67,20 +35,59 @@ void TimerOn() {
 
 void TimerOff() {
 	TCCR2B 	= 0x00; // bit3bit2bit1bit0=0000: timer off
+	TIMSK2 	= 0x00;
+}
+
+// Current time in ticks
+unsigned long TimerNow() {
+	unsigned char sreg = SREG;
+	cli();
+	unsigned char low = TCNT2;
+	unsigned long high = _avr_timer_overflows;
+	// overflow that happened after cli() and hasn't been counted yet
+	if ((TIFR2 & (1 << TOV2)) && low < 0x80) {
+		++high;
+	}
+	SREG = sreg;
+	return (high << 8) | low;
 }
 
+// Sleep until TimerNow() reaches deadline. Deadlines more than 255 ticks out are
+// reached in steps, the overflow interrupt wakes the CPU every 256 ticks anyway.
+// Other interrupts (SPI, Timer1, pin changes) wake it too, the loop just goes back
+// to sleep if it isn't time yet.
+void TimerSleepUntil(unsigned long deadline) {
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	while (true) {
+		cli();
+		long remaining = (long)(deadline - TimerNow());
+		if (remaining <= 0) {
+			break;
+		}
+		if (remaining < 256) {
+			OCR2A = (unsigned char)deadline;	// fires when TCNT2 gets there
+			TIFR2 = (1 << OCF2A);
+			TIMSK2 |= (1 << OCIE2A);
+		}
+		sleep_enable();
+		sei();		// the instruction after sei() runs before any interrupt,
+		sleep_cpu();	// so a wakeup between the check and here isn't lost
+		sleep_disable();
+	}
+	TIMSK2 &= ~(1 << OCIE2A);
+	sei();
+}
 
 
-// In our approach, the C programmer does not touch this ISR, but rather TimerISR()
-ISR(TIMER2_COMPA_vect)
+ISR(TIMER2_OVF_vect)
 {
-	// CPU automatically calls when TCNT0 == OCR0 (every 1 ms per TimerOn settings)
-	_avr_timer_cntcurr--; 			// Count down to 0 rather than up to TOP
-	if (_avr_timer_cntcurr == 0) { 	// results in a more efficient compare
-		TimerISR(); 				// Call the ISR that the user uses
-		_avr_timer_cntcurr = _avr_timer_M;
-	}
+	++_avr_timer_overflows;
+}
 
+// Only here to wake the CPU, TimerSleepUntil() does the rest
+ISR(TIMER2_COMPA_vect)
+{
+	TIMSK2 &= ~(1 << OCIE2A);
 }
 
 
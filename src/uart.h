@@ -0,0 +1,52 @@
+#ifndef UART_H
+#define UART_H
+
+#include "hal.h"
+
+// Minimal polled USART0 (TX on D1, RX on D0) for reports. Open the serial monitor
+// at UART_BAUD to read them. Nothing here uses interrupts.
+
+#ifndef UART_BAUD
+#define UART_BAUD 115200UL
+#endif
+
+void UART_INIT() {
+    UCSR0A = (1 << U2X0); // double speed, much smaller baud error at 115200
+    UBRR0 = (F_CPU / 8 / UART_BAUD) - 1;
+    UCSR0B = (1 << TXEN0) | (1 << RXEN0);
+    UCSR0C = (1 << UCSZ01) | (1 << UCSZ00); // 8N1
+}
+
+void UART_SEND(char c) {
+    while (!(UCSR0A & (1 << UDRE0)));
+    UDR0 = c;
+}
+
+// True if a byte came in, read it with UART_READ()
+bool UART_AVAILABLE() {
+    return UCSR0A & (1 << RXC0);
+}
+
+char UART_READ() {
+    return UDR0;
+}
+
+void UART_PRINT(const char *str) {
+    while (*str) {
+        UART_SEND(*str++);
+    }
+}
+
+void UART_PRINT_NUM(unsigned long num) {
+    char digits[10];
+    unsigned char count = 0;
+    do {
+        digits[count++] = '0' + (num % 10);
+        num /= 10;
+    } while (num);
+    while (count) {
+        UART_SEND(digits[--count]);
+    }
+}
+
+#endif // UART_H
@@ -0,0 +1,62 @@
+// Dirty rectangle tests: pio test -e native
+//
+// Drives st7735.h against the simulated panel (src/native/st7735_sim.h) without the
+// game, for the cases the scripted game in test_golden doesn't reach.
+
+#include <unity.h>
+
+#include "../../src/hal.h"
+#include "../../src/spi.h"
+#include "../../src/st7735.h"
+#include "../../src/font.h"
+
+#define WHITE 0xFFFF
+
+// Pixels in the glyph cell at (x, y) that aren't white
+int inkIn(int x, int y) {
+  int ink = 0;
+  for (int row = y; row < y + FONT_HEIGHT; ++row) {
+    for (int col = x; col < x + FONT_WIDTH; ++col) {
+      ink += (simPanel[row][col] != WHITE);
+    }
+  }
+  return ink;
+}
+
+// A clear cut by three glyphs in different rows and columns leaves 10 pieces, more
+// than ST7735_DIRTY_MAX, so the third glyph's window sends the queue first. That
+// happens inside the glyph's own transaction, which has to keep CS down throughout.
+void test_overflow_inside_a_window() {
+  unsigned long breaks = simPanelTotal.csBreaks + simPanelFrame.csBreaks;
+
+  st7735_fillRect(0, 127, 0, 127, WHITE);
+  drawChar(50, 50, 'S', 0x0000, WHITE);
+  drawChar(50, 10, 'T', 0x0000, WHITE);
+  TEST_ASSERT_TRUE(st7735_dirtyPending());
+  drawChar(50, 90, 'A', 0x0000, WHITE);
+  TEST_ASSERT_FALSE_MESSAGE(st7735_dirtyPending(), "the queue didn't overflow");
+  st7735_flushDirty();
+  SPI_FLUSH();
+
+  TEST_ASSERT_EQUAL_MESSAGE(0, simPanelTotal.csBreaks + simPanelFrame.csBreaks - breaks,
+                            "CS went high in the middle of a window");
+  TEST_ASSERT_TRUE(inkIn(50, 50) > 0);
+  TEST_ASSERT_TRUE(inkIn(50, 10) > 0);
+  TEST_ASSERT_TRUE(inkIn(50, 90) > 0);
+  TEST_ASSERT_EQUAL_INT(WHITE, simPanel[0][0]);
+  TEST_ASSERT_EQUAL_INT(WHITE, simPanel[127][127]);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  SPI_INIT();
+  sei();
+  st7735_resetBegin();
+  st7735_resetEnd();
+  st7735_setup();
+  RUN_TEST(test_overflow_inside_a_window);
+  return UNITY_END();
+}
@@ -0,0 +1,274 @@
+// Golden frame tests: pio test -e native
+//
+// Plays a scripted game on the host simulator (see src/native/sim.h) and compares the
+// simulated panel against stored images at every screen: title, play, the first block
+// placed, the tower after it has scrolled round the frame memory ring once, win and
+// lose. The script waits for game state, not for time,
+// so a faster or slower render path still reaches the same frames; only what ends up
+// on the panel has to stay the same. What the frame left on the display list is drawn
+// before the comparison.
+//
+// A frame that doesn't match is written next to its golden as <name>.actual.ppm.
+// After an intended change to what the screens look like, run with GOLDEN_UPDATE=1
+// to rewrite the goldens, and look at them before committing.
+
+#include <unity.h>
+
+#define WIN_LEVEL 15 // the game plays on forever without one; 15 takes the tower round the ring
+#define main stackerinoMain
+#include "../../src/main.cpp"
+#undef main
+
+#define GOLDEN_TIMEOUT_MS 120000 // of simulated time, for the whole script
+#define GOLDEN_HOLD_MS 150       // long enough for the 100 ms menu task to see it
+#define GOLDEN_TAP_MS 30         // a drop, over before the menu task looks again
+#define GOLDEN_REPEAT_MS 300     // earliest next press after one
+#define GOLDEN_DROP_SLACK 2      // px from the target a drop may be, well inside ALIGN_TOLERANCE
+
+// Directory of this file, the goldens live in golden/ next to it
+const char *goldenDir() {
+  static char dir[256];
+  if (!dir[0]) {
+    strncpy(dir, __FILE__, sizeof(dir) - 1);
+    char *slash = strrchr(dir, '/');
+    if (slash) {
+      slash[1] = '\0';
+    }
+    else {
+      dir[0] = '\0';
+    }
+  }
+  return dir;
+}
+
+void compareGolden(const char *name) {
+  dlFinish();
+  char path[320];
+  snprintf(path, sizeof(path), "%sgolden/%s.ppm", goldenDir(), name);
+
+  if (getenv("GOLDEN_UPDATE")) {
+    TEST_ASSERT_TRUE_MESSAGE(simPanelWritePpm(path), path);
+    return;
+  }
+
+  FILE *file = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+  int width = 0, height = 0, depth = 0;
+  int fields = fscanf(file, "P6 %d %d %d", &width, &height, &depth);
+  fgetc(file); // the single whitespace before the pixels
+  TEST_ASSERT_EQUAL_INT(3, fields);
+  TEST_ASSERT_EQUAL_INT(SIM_PANEL_WIDTH, width);
+  TEST_ASSERT_EQUAL_INT(SIM_PANEL_HEIGHT, height);
+
+  unsigned long wrong = 0;
+  int firstCol = -1, firstRow = -1;
+  for (int row = 0; row < SIM_PANEL_HEIGHT; ++row) {
+    for (int col = 0; col < SIM_PANEL_WIDTH; ++col) {
+      unsigned char expected[3], actual[3];
+      if (fread(expected, 1, 3, file) != 3) {
+        fclose(file);
+        TEST_FAIL_MESSAGE("golden image is cut short");
+      }
+      simPanelRgb888(col, row, actual);
+      if (memcmp(expected, actual, 3) != 0) {
+        if (!wrong) {
+          firstCol = col;
+          firstRow = row;
+        }
+        ++wrong;
+      }
+    }
+  }
+  fclose(file);
+
+  if (wrong) {
+    char actualPath[320];
+    snprintf(actualPath, sizeof(actualPath), "%sgolden/%s.actual.ppm", goldenDir(), name);
+    simPanelWritePpm(actualPath);
+    char message[400];
+    snprintf(message, sizeof(message), "%lu pixels differ, first at column %d row %d, see %s",
+             wrong, firstCol, firstRow, actualPath);
+    TEST_FAIL_MESSAGE(message);
+  }
+}
+
+void test_title_screen() { compareGolden("title"); }
+void test_play_screen() { compareGolden("play"); }
+void test_first_block_placed() { compareGolden("placed"); }
+void test_full_tower() { compareGolden("tower"); }
+void test_win_screen() { compareGolden("win"); }
+void test_lose_screen() { compareGolden("lose"); }
+
+// Up to the win screen's confetti, no task had to wait for room in the display list
+void test_win_screen_without_stalls() {
+  TEST_ASSERT_EQUAL_MESSAGE(0, dlStalls, "a task drew to make room in the display list");
+}
+
+// Over the whole game, CS stayed low from every window's CASET/RASET to its last pixel
+void test_cs_held_through_windows() {
+  TEST_ASSERT_EQUAL_MESSAGE(0, simPanelTotal.csBreaks + simPanelFrame.csBreaks,
+                            "CS went high in the middle of a window");
+}
+
+/*****************************************************************************/
+// The script, advanced at the end of every pass of the main loop
+
+enum goldenScript {waitTitle, waitPlay, waitPlaced, waitTower, waitWin, waitTitleAgain,
+                  waitPlayAgain, waitLose, finished};
+
+unsigned char goldenStage = waitTitle;
+unsigned long goldenNextPress = 0;   // ms, see GOLDEN_REPEAT_MS
+unsigned long goldenMenuLast = 0;    // tasks[0].lastTime at the previous frame
+unsigned char goldenMenuTicks = 0;   // menu ticks seen since the stage began
+bool goldenMenuTicked = false;       // the menu task ran in this frame
+
+void goldenNext(unsigned char stage) {
+  goldenStage = stage;
+  goldenMenuTicks = 0;
+}
+
+// Press a button and let go hold ms later, unless the last press is too recent
+bool goldenPress(unsigned char line, unsigned long hold) {
+  unsigned long now = simNowMs();
+  if ((long)(now - goldenNextPress) < 0) {
+    return false;
+  }
+  simSetInput(line, true);
+  simScheduleInput(now + hold, line, false);
+  goldenNextPress = now + GOLDEN_REPEAT_MS;
+  return true;
+}
+
+// Drop the moving block if it is near x and the game is waiting for a drop. Only
+// right after a menu tick, so the button is up again by the next one: the lose and
+// win states reset the game when they see it held.
+void goldenDropNear(int x) {
+  if (goldenMenuTicked && gamePlaying && tasks[2].state == waitPress
+      && xS >= x - GOLDEN_DROP_SLACK && xS <= x + GOLDEN_DROP_SLACK) {
+    goldenPress(BUTTON_PLACE, GOLDEN_TAP_MS);
+  }
+}
+
+void goldenFinish() {
+  goldenStage = finished;
+  RUN_TEST(test_cs_held_through_windows);
+  exit(UNITY_END());
+}
+
+void goldenFrame() {
+  goldenMenuTicked = (tasks[0].lastTime != goldenMenuLast);
+  if (goldenMenuTicked) {
+    goldenMenuLast = tasks[0].lastTime;
+    ++goldenMenuTicks;
+  }
+
+  switch (goldenStage) {
+    case waitTitle:
+      if (screenOnPanel == SCREEN_TITLE) {
+        RUN_TEST(test_title_screen);
+        goldenPress(BUTTON_START, GOLDEN_HOLD_MS);
+        goldenNext(waitPlay);
+      }
+      break;
+
+    case waitPlay:
+      // the moving block's first draw is always at the right edge
+      if (gamePlaying && movingBlock.drawn) {
+        RUN_TEST(test_play_screen);
+        goldenNext(waitPlaced);
+      }
+      break;
+
+    case waitPlaced:
+      // the frame a drop lands in has the tower only, the moving block follows later
+      if (level == 2) {
+        RUN_TEST(test_first_block_placed);
+        goldenNext(waitTower);
+      }
+      else {
+        goldenDropNear(prevBlockXS);
+      }
+      break;
+
+    case waitTower:
+      if (level == WIN_LEVEL) {
+        RUN_TEST(test_full_tower);
+        goldenNext(waitWin);
+      }
+      else {
+        goldenDropNear(prevBlockXS);
+      }
+      break;
+
+    case waitWin:
+      // the move task clears the panel after the first win tick, the second one stays
+      if (tasks[0].state == winGame && goldenMenuTicks >= 2) {
+        if (goldenMenuTicked && goldenMenuTicks == 2) {
+          RUN_TEST(test_win_screen);
+          RUN_TEST(test_win_screen_without_stalls);
+        }
+        // the last drop may be too recent for a press yet
+        if (goldenPress(BUTTON_PLACE, GOLDEN_HOLD_MS)) {
+          goldenNext(waitTitleAgain);
+        }
+      }
+      else if (tasks[0].state != winGame) {
+        goldenMenuTicks = 0;
+      }
+      break;
+
+    case waitTitleAgain:
+      if (tasks[0].state == menuIdle && screenOnPanel == SCREEN_TITLE && goldenPress(BUTTON_START, GOLDEN_HOLD_MS)) {
+        goldenNext(waitPlayAgain);
+      }
+      break;
+
+    case waitPlayAgain:
+      if (gamePlaying && movingBlock.drawn) {
+        goldenNext(waitLose);
+      }
+      break;
+
+    case waitLose:
+      if (tasks[0].state == loseGame && goldenMenuTicks >= 2) {
+        RUN_TEST(test_lose_screen);
+        goldenFinish();
+      }
+      else if (tasks[0].state != loseGame) {
+        goldenMenuTicks = 0;
+        goldenDropNear(0); // nowhere near the base
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*****************************************************************************/
+
+void (*goldenPanelStop)();
+
+void test_script_finished() {
+  TEST_ASSERT_EQUAL_MESSAGE(finished, goldenStage, "ran out of time before the last screen");
+}
+
+// Simulated time ran out before the script got through
+void goldenTimeout() {
+  goldenPanelStop();
+  RUN_TEST(test_script_finished);
+  exit(UNITY_END());
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  simOnFrame = goldenFrame;
+  goldenPanelStop = simOnStop;
+  simOnStop = goldenTimeout;
+  simStopAt(GOLDEN_TIMEOUT_MS);
+  stackerinoMain();
+  return UNITY_END();
+}